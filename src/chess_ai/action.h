@@ -10,29 +10,27 @@
 #define CHESS_AI_ACTION_H_
 
 #include <cstdint>
-#include <unordered_map>
+#include <functional>
 
 #include "bitboard.h"
 #include "chess-pieces.h"
 #include "color.h"
+#include "constants.h"
 
 // Action bit layout:
 // 0      : Color (0 = white, 1 = black)
 // 1-6    : From Index
 // 7-12   : To Index
 // 13-15  : Unused
-// 16-18  : Piece type moved (001=king, 010=pawn, 011=bishop, 100=knight,
-//          101=rook, 110=queen)
+// 16-18  : Piece type moved (Piece value + 1)
 // 19     : Double pawn forward flag
 // 20     : Queen side castle flag
 // 21     : King side castle flag
 // 22     : Checking flag (will put opponent in check)
-// 23-25  : Capture type (000=none, 010=pawn, 011=bishop, 100=knight,
-//          101=rook, 110=queen)
+// 23-25  : Capture type (000=none, otherwise Piece value + 1)
 // 26     : En passant flag
 // 27     : Equal capture flag (capturing same piece type)
-// 28-30  : Promotion type (001=none, 011=bishop, 100=knight, 101=rook,
-//          110=queen)
+// 28-30  : Promotion type (000=none, otherwise Piece value + 1)
 // 31     : Winning capture flag (capture is of higher value piece)
 
 namespace ChessEngine {
@@ -41,29 +39,50 @@ class Action {
  public:
   uint32_t Key() const { return action_; }
 
-  Piece GetPiece() const { return ActionToPieceMoved(action_); }
-  Color GetColor() const { return ActionToColor(action_); }
+  Piece GetPiece() const { return CodeToPiece(Field(action_, kPieceShift)); }
+  Color GetColor() const {
+    return static_cast<Color>(Field(action_, kColorShift, 0x01));
+  }
+
+  // Square indices, 0 = a1 through 63 = h8.
+  int From() const { return Field(action_, kFromShift, kSquareMask); }
+  int To() const { return Field(action_, kToShift, kSquareMask); }
 
-  Bitboard PieceBefore() const { return ActionToPieceBefore(action_); }
-  Bitboard PieceAfter() const { return ActionToPieceAfter(action_); }
+  Bitboard PieceBefore() const { return Bitboard(uint64_t{1} << From()); }
+  Bitboard PieceAfter() const { return Bitboard(uint64_t{1} << To()); }
 
-  bool DoublePawnForward() const { return ActionToDoublePawnForward(action_); }
+  bool DoublePawnForward() const {
+    return Field(action_, kDoublePawnForwardShift, 0x01);
+  }
 
-  bool QueenSideCastling() const { return ActionToQueenSideCastle(action_); }
-  bool KingSideCastling() const { return ActionToKingSideCastle(action_); }
+  bool QueenSideCastling() const {
+    return Field(action_, kQueenSideCastleShift, 0x01);
+  }
+  bool KingSideCastling() const {
+    return Field(action_, kKingSideCastleShift, 0x01);
+  }
 
-  bool EnemyInCheck() const { return ActionToEnemyInCheck(action_); }
+  bool EnemyInCheck() const { return Field(action_, kEnemyInCheckShift, 0x01); }
 
-  bool WasCapture() const { return ActionToWasCapture(action_); }
-  Piece PieceCaptured() const { return ActionToPieceCaptured(action_); }
+  bool WasCapture() const { return Field(action_, kCaptureShift) != 0; }
+  Piece PieceCaptured() const {
+    return CodeToPiece(Field(action_, kCaptureShift));
+  }
   bool WasEnPassantCapture() const {
-    return ActionToWasEnpassantCapture(action_);
+    return Field(action_, kEnPassantShift, 0x01);
   }
 
-  bool WasEqualCapture() const { return ActionToWasEqualPieceCapture(action_); }
+  bool WasEqualCapture() const {
+    return Field(action_, kEqualCaptureShift, 0x01);
+  }
+  bool WasWinningCapture() const {
+    return Field(action_, kWinningCaptureShift, 0x01);
+  }
 
-  bool WasPromotion() const { return ActionToWasPromotion(action_); }
-  Piece PromotedTo() const { return ActionToPromotedTo(action_); }
+  bool WasPromotion() const { return Field(action_, kPromotionShift) != 0; }
+  Piece PromotedTo() const {
+    return CodeToPiece(Field(action_, kPromotionShift));
+  }
 
   bool operator<(const Action& other) const {
     return action_ < other.action_;
@@ -79,21 +98,15 @@ class Action {
          const Bitboard& piece_after, bool double_pawn_forward,
          bool queen_side_castling, bool king_side_castling, bool enemy_in_check,
          bool was_capture, bool was_en_passant_capture, Piece piece_captured,
-         bool was_promotion, Piece promoted_to) {
-    action_ = 0 | ColorToBitboard(color) |
-              PieceBeforeToBitboard(piece_before) |
-              PieceAfterToBitboard(piece_after) |
-              PieceMovedToBitboard(piece) |
-              DoublePawnForwardToBitboard(double_pawn_forward) |
-              QueenSideCastleToBitboard(queen_side_castling) |
-              KingSideCastleToBitboard(king_side_castling) |
-              EnemyInCheckToBitboard(enemy_in_check) |
-              PieceCapturedToBitboard(was_capture, piece_captured) |
-              WasEnPassantCaptureToBitboard(was_en_passant_capture) |
-              WasEqualPieceCaptureToBitboard(was_capture, piece,
-                                             piece_captured) |
-              PromotionToBitboard(was_promotion, promoted_to);
-  }
+         bool was_promotion, Piece promoted_to)
+      : action_(Pack(color, piece_before.Lsb(), piece_after.Lsb(), piece,
+                     double_pawn_forward, queen_side_castling,
+                     king_side_castling, enemy_in_check, was_capture,
+                     was_en_passant_capture, piece_captured, was_promotion,
+                     promoted_to)) {}
+
+  // Rebuilds an action from its Key().
+  explicit Action(uint32_t key) : action_(key) {}
 
   Action() = default;
   Action(const Action& other) = default;
@@ -102,44 +115,65 @@ class Action {
  private:
   uint32_t action_;
 
-  static uint32_t ColorToBitboard(Color color);
-  static Color ActionToColor(uint32_t board);
-
-  static uint32_t PieceBeforeToBitboard(const Bitboard& before);
-  static Bitboard ActionToPieceBefore(uint32_t board);
-
-  static uint32_t PieceAfterToBitboard(const Bitboard& after);
-  static Bitboard ActionToPieceAfter(uint32_t board);
-
-  static uint32_t PieceMovedToBitboard(Piece piece);
-  static Piece ActionToPieceMoved(uint32_t board);
-
-  static uint32_t DoublePawnForwardToBitboard(bool double_pawn_forward);
-  static bool ActionToDoublePawnForward(uint32_t board);
-
-  static uint32_t QueenSideCastleToBitboard(bool queen_side_castling);
-  static bool ActionToQueenSideCastle(uint32_t board);
-
-  static uint32_t KingSideCastleToBitboard(bool king_side_castling);
-  static bool ActionToKingSideCastle(uint32_t board);
-
-  static uint32_t EnemyInCheckToBitboard(bool enemy_in_check);
-  static bool ActionToEnemyInCheck(uint32_t board);
-
-  static uint32_t PieceCapturedToBitboard(bool was_capture, Piece piece);
-  static Piece ActionToPieceCaptured(uint32_t board);
-  static bool ActionToWasCapture(uint32_t board);
+  static constexpr int kColorShift = 0;
+  static constexpr int kFromShift = 1;
+  static constexpr int kToShift = 7;
+  static constexpr int kPieceShift = 16;
+  static constexpr int kDoublePawnForwardShift = 19;
+  static constexpr int kQueenSideCastleShift = 20;
+  static constexpr int kKingSideCastleShift = 21;
+  static constexpr int kEnemyInCheckShift = 22;
+  static constexpr int kCaptureShift = 23;
+  static constexpr int kEnPassantShift = 26;
+  static constexpr int kEqualCaptureShift = 27;
+  static constexpr int kPromotionShift = 28;
+  static constexpr int kWinningCaptureShift = 31;
+
+  static constexpr uint32_t kSquareMask = 0x3f;
+  static constexpr uint32_t kPieceMask = 0x07;
+
+  static constexpr uint32_t Field(uint32_t action, int shift,
+                                  uint32_t mask = kPieceMask) {
+    return (action >> shift) & mask;
+  }
 
-  static uint32_t WasEnPassantCaptureToBitboard(bool was_en_passant_capture);
-  static bool ActionToWasEnpassantCapture(uint32_t board);
+  static constexpr uint32_t Flag(bool value, int shift) {
+    return static_cast<uint32_t>(value) << shift;
+  }
 
-  static uint32_t WasEqualPieceCaptureToBitboard(bool was_capture, Piece piece,
-                                                 Piece capture_piece);
-  static bool ActionToWasEqualPieceCapture(uint32_t board);
+  // Pieces are stored one above their enum value so that zero means none.
+  // An empty field decodes as kKing, which callers never read without
+  // checking WasCapture or WasPromotion first.
+  static constexpr uint32_t PieceToCode(Piece piece) {
+    return static_cast<uint32_t>(piece) + 1;
+  }
+  static constexpr Piece CodeToPiece(uint32_t code) {
+    return code == 0 ? kKing : static_cast<Piece>(code - 1);
+  }
 
-  static uint32_t PromotionToBitboard(bool was_promotion, Piece promoted_to);
-  static bool ActionToWasPromotion(uint32_t board);
-  static Piece ActionToPromotedTo(uint32_t board);
+  static constexpr uint32_t Pack(Color color, int from, int to, Piece piece,
+                                 bool double_pawn_forward,
+                                 bool queen_side_castling,
+                                 bool king_side_castling, bool enemy_in_check,
+                                 bool was_capture, bool was_en_passant_capture,
+                                 Piece piece_captured, bool was_promotion,
+                                 Piece promoted_to) {
+    return (static_cast<uint32_t>(color) << kColorShift) |
+           (static_cast<uint32_t>(from) << kFromShift) |
+           (static_cast<uint32_t>(to) << kToShift) |
+           (PieceToCode(piece) << kPieceShift) |
+           Flag(double_pawn_forward, kDoublePawnForwardShift) |
+           Flag(queen_side_castling, kQueenSideCastleShift) |
+           Flag(king_side_castling, kKingSideCastleShift) |
+           Flag(enemy_in_check, kEnemyInCheckShift) |
+           (was_capture ? PieceToCode(piece_captured) << kCaptureShift : 0) |
+           Flag(was_en_passant_capture, kEnPassantShift) |
+           Flag(was_capture && piece == piece_captured, kEqualCaptureShift) |
+           (was_promotion ? PieceToCode(promoted_to) << kPromotionShift : 0) |
+           Flag(was_capture &&
+                    kPieceValues[piece_captured] > kPieceValues[piece],
+                kWinningCaptureShift);
+  }
 };
 
 }  // namespace ChessEngine
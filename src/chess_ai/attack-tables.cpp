@@ -0,0 +1,192 @@
+//
+//  attack-tables.cpp
+//  chess_ai
+//
+//  Created by Illya Starikov on 10/14/26.
+//  Copyright 2026. Illya Starikov. All rights reserved.
+//
+
+#include "attack-tables.h"
+
+namespace ChessEngine {
+
+namespace {
+
+// Magic multipliers found offline by random search. Each one maps every
+// blocker subset of its square to a distinct (or constructively colliding)
+// slot using exactly popcount(mask) index bits, so the PEXT build can share
+// the same table layout.
+const uint64_t kRookMagics[64] = {
+    0x1080004008801020, 0x0840092002c03000, 0x1900200010400900,
+    0x0880100008000480, 0x4200100420080200, 0x8100020100080400,
+    0x0200040110886200, 0x0200008040220411, 0x0404800084400220,
+    0x0000401000402000, 0x0086001081220440, 0x0408800800100280,
+    0x000a001201040820, 0x8848800200840080, 0x4001000100040200,
+    0x0442000102105084, 0x9080010020804100, 0x0040404000201009,
+    0x0000808010002009, 0x2200090021d00100, 0x0008008008040080,
+    0x0004004002010040, 0x0011040008015042, 0x00000a0001768104,
+    0x0000800080204009, 0x2010004140002001, 0x9800200280100080,
+    0x1000100080080080, 0x0442000a00049020, 0x2100040080020080,
+    0x0800120400900148, 0x0010040a00128541, 0x2800804000800030,
+    0x1010002000400041, 0x4000200011004100, 0x0610008410800800,
+    0x0400802402800800, 0xc100020080800400, 0x0002000802000401,
+    0x0182085882000401, 0x0220204000808000, 0x2860100040024022,
+    0x0001002004110040, 0x99101042000a0020, 0x0004080004008080,
+    0x0010040002008080, 0x2012004881020004, 0x8300842444820011,
+    0x0088403882010200, 0x0820400080210100, 0x0110910040a00300,
+    0x0801100280080480, 0x0242009008200600, 0x1002000489500200,
+    0x0040800200010080, 0x0091800041000080, 0x0000209300488001,
+    0x04c1002414824001, 0x020020000b001041, 0x7000100004200901,
+    0x8002002004100802, 0x30010002084c0007, 0x0888221800813004,
+    0x4000002840840112};
+
+const uint64_t kBishopMagics[64] = {
+    0xa010041108003100, 0x006082020a002900, 0x6810010619200000,
+    0x08281a0520000408, 0x0001104001000400, 0x0018901008048400,
+    0x00040a0210245280, 0x000200210808a402, 0x9140048410821200,
+    0x0800091010820041, 0x20504804832202c0, 0x0100091401081000,
+    0x8021011140000012, 0x0810020804450400, 0x208b0542109008a2,
+    0x0080084a08040204, 0x0040e2a80811244c, 0x2505022008008108,
+    0x0430220100420040, 0x010a040420220040, 0x1105000290400000,
+    0x0093001200822120, 0x4000a62048043004, 0x280120048a015004,
+    0x006090002a020814, 0x44042000240800d0, 0x01102800040a4400,
+    0x1004080080220040, 0x0001001011004024, 0x0010044000805040,
+    0x0914041200820100, 0x0004821012821480, 0x0024040500c05021,
+    0x0088611002080200, 0x0116080a00040020, 0x4000020080080080,
+    0x2450450140840040, 0x0000880201484100, 0x0222020404020092,
+    0x8081110600002e00, 0x2842101105000801, 0x1100809008001025,
+    0x00020202221c0400, 0x0422014022009020, 0x0210046102100c00,
+    0xc004008082029102, 0x00aa461801101200, 0x0404080080201108,
+    0x020542108c205002, 0x0410544804100100, 0x0040910841100000,
+    0x0400200042021100, 0x00004204850400c0, 0x0200100410a42102,
+    0x1040020801210102, 0x0805040410420000, 0x2884804130100200,
+    0x800c262201242000, 0x1058000194108800, 0x0014221054420204,
+    0x0104000012a02200, 0x0200881003300100, 0x0140400202840100,
+    0x0402020801010201};
+
+// File and rank steps for each sliding direction.
+const int kRookDirections[4][2] = {{0, 1}, {0, -1}, {1, 0}, {-1, 0}};
+const int kBishopDirections[4][2] = {{1, 1}, {-1, 1}, {1, -1}, {-1, -1}};
+
+bool OnBoard(int file, int rank) {
+  return file >= 0 && file < 8 && rank >= 0 && rank < 8;
+}
+
+uint64_t RayAttacks(int square, uint64_t occupancy,
+                    const int (*directions)[2]) {
+  uint64_t attacks = 0;
+
+  for (int i = 0; i < 4; i++) {
+    int file = square % 8 + directions[i][0];
+    int rank = square / 8 + directions[i][1];
+
+    // Walk until falling off the board, keeping the first blocker.
+    while (OnBoard(file, rank)) {
+      uint64_t target = 1ULL << (8 * rank + file);
+      attacks |= target;
+      if (occupancy & target) {
+        break;
+      }
+      file += directions[i][0];
+      rank += directions[i][1];
+    }
+  }
+
+  return attacks;
+}
+
+uint64_t RelevantBlockers(int square, const int (*directions)[2]) {
+  uint64_t mask = 0;
+
+  for (int i = 0; i < 4; i++) {
+    int file = square % 8 + directions[i][0];
+    int rank = square / 8 + directions[i][1];
+
+    // The last square of a ray never changes the attack set.
+    while (OnBoard(file + directions[i][0], rank + directions[i][1])) {
+      mask |= 1ULL << (8 * rank + file);
+      file += directions[i][0];
+      rank += directions[i][1];
+    }
+  }
+
+  return mask;
+}
+
+}  // namespace
+
+AttackTables::Magic AttackTables::rook_magics_[64];
+AttackTables::Magic AttackTables::bishop_magics_[64];
+
+uint64_t AttackTables::rook_attacks_[0x19000];
+uint64_t AttackTables::bishop_attacks_[0x1480];
+
+uint64_t AttackTables::between_[64][64];
+uint64_t AttackTables::line_[64][64];
+
+const bool AttackTables::initialized_ = (AttackTables::Initialize(), true);
+
+void AttackTables::Initialize() {
+  InitializeSlider(rook_magics_, rook_attacks_, kRookMagics, kRookDirections);
+  InitializeSlider(bishop_magics_, bishop_attacks_, kBishopMagics,
+                   kBishopDirections);
+  InitializeLines();
+}
+
+void AttackTables::InitializeLines() {
+  const Bitboard kEmpty(0);
+
+  for (int from = 0; from < 64; from++) {
+    Bitboard from_square = Bitboard().FromIndex(from);
+
+    for (int to = 0; to < 64; to++) {
+      Bitboard to_square = Bitboard().FromIndex(to);
+
+      // Seen from both ends with the other end as the only blocker, the
+      // attacks overlap exactly between the two squares.
+      if ((RookAttacks(from, kEmpty) & to_square) != kEmpty) {
+        between_[from][to] =
+            (RookAttacks(from, to_square) & RookAttacks(to, from_square))
+                .board_;
+        line_[from][to] =
+            ((RookAttacks(from, kEmpty) & RookAttacks(to, kEmpty)) |
+             from_square | to_square)
+                .board_;
+      } else if ((BishopAttacks(from, kEmpty) & to_square) != kEmpty) {
+        between_[from][to] =
+            (BishopAttacks(from, to_square) & BishopAttacks(to, from_square))
+                .board_;
+        line_[from][to] =
+            ((BishopAttacks(from, kEmpty) & BishopAttacks(to, kEmpty)) |
+             from_square | to_square)
+                .board_;
+      }
+    }
+  }
+}
+
+void AttackTables::InitializeSlider(Magic* magics, uint64_t* attacks,
+                                    const uint64_t* magic_numbers,
+                                    const int (*directions)[2]) {
+  uint64_t* slice = attacks;
+
+  for (int square = 0; square < 64; square++) {
+    Magic& entry = magics[square];
+    entry.mask = RelevantBlockers(square, directions);
+    entry.magic = magic_numbers[square];
+    entry.shift = 64 - Bitboard(entry.mask).PopCount();
+    entry.attacks = slice;
+
+    // Enumerate every subset of the mask (Carry-Rippler).
+    uint64_t subset = 0;
+    do {
+      entry.attacks[Index(entry, subset)] =
+          RayAttacks(square, subset, directions);
+      subset = (subset - entry.mask) & entry.mask;
+    } while (subset);
+
+    slice += 1ULL << (64 - entry.shift);
+  }
+}
+
+}  // namespace ChessEngine
@@ -0,0 +1,141 @@
+//
+//  attack-tables.h
+//  chess_ai
+//
+//  Created by Illya Starikov on 10/14/26.
+//  Copyright 2026. Illya Starikov. All rights reserved.
+//
+
+#ifndef CHESS_AI_ATTACK_TABLES_H_
+#define CHESS_AI_ATTACK_TABLES_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(USE_PEXT)
+#include <immintrin.h>
+#endif
+
+#include "bitboard.h"
+#include "color.h"
+
+namespace ChessEngine {
+
+// File and rank steps of the non-sliding pieces.
+constexpr int kKingSteps[8][2] = {{0, 1},  {0, -1}, {1, 0},  {-1, 0},
+                                  {1, 1},  {-1, 1}, {1, -1}, {-1, -1}};
+constexpr int kKnightSteps[8][2] = {{1, 2},  {2, 1},  {2, -1}, {1, -2},
+                                    {-1, -2}, {-2, -1}, {-2, 1}, {-1, 2}};
+constexpr int kWhitePawnSteps[2][2] = {{1, 1}, {-1, 1}};
+constexpr int kBlackPawnSteps[2][2] = {{1, -1}, {-1, -1}};
+
+template <size_t N>
+constexpr std::array<uint64_t, 64> StepAttackTable(const int (&steps)[N][2]) {
+  std::array<uint64_t, 64> table{};
+
+  for (int square = 0; square < 64; square++) {
+    for (size_t i = 0; i < N; i++) {
+      int file = square % 8 + steps[i][0];
+      int rank = square / 8 + steps[i][1];
+
+      if (file >= 0 && file < 8 && rank >= 0 && rank < 8) {
+        table[square] |= 1ULL << (8 * rank + file);
+      }
+    }
+  }
+
+  return table;
+}
+
+// Precomputed attack sets. For sliders, every square owns a slice of a shared
+// table indexed by the blockers on its rays: a magic multiply hashes them by
+// default, and builds with PEXT=1 extract them directly with BMI2 PEXT. The
+// returned attacks include the first blocker in each direction, regardless
+// of its color. Slider tables are filled once during static initialization.
+class AttackTables {
+ public:
+  static Bitboard RookAttacks(int square, const Bitboard& occupancy) {
+    const Magic& entry = rook_magics_[square];
+    return Bitboard(entry.attacks[Index(entry, occupancy.board_)]);
+  }
+
+  static Bitboard BishopAttacks(int square, const Bitboard& occupancy) {
+    const Magic& entry = bishop_magics_[square];
+    return Bitboard(entry.attacks[Index(entry, occupancy.board_)]);
+  }
+
+  static Bitboard QueenAttacks(int square, const Bitboard& occupancy) {
+    return RookAttacks(square, occupancy) | BishopAttacks(square, occupancy);
+  }
+
+  // Non-sliding attacks, generated at compile time.
+  static Bitboard KingAttacks(int square) {
+    return Bitboard(kKingAttacks[square]);
+  }
+
+  static Bitboard KnightAttacks(int square) {
+    return Bitboard(kKnightAttacks[square]);
+  }
+
+  // Squares a pawn of the given color on the square attacks.
+  static Bitboard PawnAttacks(Color color, int square) {
+    return Bitboard(kPawnAttacks[color][square]);
+  }
+
+  // The squares strictly between two squares on a shared rank, file or
+  // diagonal, and empty otherwise.
+  static Bitboard Between(int from, int to) {
+    return Bitboard(between_[from][to]);
+  }
+
+  // The whole rank, file or diagonal through two squares, and empty if they
+  // share none.
+  static Bitboard Line(int from, int to) { return Bitboard(line_[from][to]); }
+
+ private:
+  struct Magic {
+    uint64_t mask;
+    uint64_t magic;
+    uint64_t* attacks;
+    int shift;
+  };
+
+  static size_t Index(const Magic& entry, uint64_t occupancy) {
+#if defined(USE_PEXT)
+    return static_cast<size_t>(_pext_u64(occupancy, entry.mask));
+#else
+    return static_cast<size_t>(((occupancy & entry.mask) * entry.magic) >>
+                               entry.shift);
+#endif
+  }
+
+  static constexpr std::array<uint64_t, 64> kKingAttacks =
+      StepAttackTable(kKingSteps);
+  static constexpr std::array<uint64_t, 64> kKnightAttacks =
+      StepAttackTable(kKnightSteps);
+  static constexpr std::array<uint64_t, 64> kPawnAttacks[2] = {
+      StepAttackTable(kWhitePawnSteps), StepAttackTable(kBlackPawnSteps)};
+
+  static void Initialize();
+  static void InitializeSlider(Magic* magics, uint64_t* attacks,
+                               const uint64_t* magic_numbers,
+                               const int (*directions)[2]);
+  static void InitializeLines();
+
+  static Magic rook_magics_[64];
+  static Magic bishop_magics_[64];
+
+  // Sum of 2^(relevant blockers) over all squares.
+  static uint64_t rook_attacks_[0x19000];
+  static uint64_t bishop_attacks_[0x1480];
+
+  static uint64_t between_[64][64];
+  static uint64_t line_[64][64];
+
+  static const bool initialized_;
+};
+
+}  // namespace ChessEngine
+
+#endif  // CHESS_AI_ATTACK_TABLES_H_
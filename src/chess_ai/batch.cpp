@@ -0,0 +1,259 @@
+//
+//  batch.cpp
+//  chess_ai
+//
+//  Created by Illya Starikov on 10/14/26.
+//  Copyright 2026. Illya Starikov. All rights reserved.
+//
+
+#include "batch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "chess-ai.h"
+#include "fen-parser.h"
+#include "timer.h"
+#include "transposition-table.h"
+#include "uci.h"
+
+namespace ChessEngine {
+
+namespace {
+
+struct BatchLine {
+  int index;
+  std::string text;
+};
+
+// Lines waiting for a worker. The reader blocks while it is full, so a
+// huge input is never held in memory at once.
+class BatchQueue {
+ public:
+  explicit BatchQueue(size_t capacity) : capacity_(capacity), closed_(false) {}
+
+  void Push(BatchLine line) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_full_.wait(lock, [this]() { return lines_.size() < capacity_; });
+    lines_.push_back(std::move(line));
+    not_empty_.notify_one();
+  }
+
+  // Fails once the queue is closed and drained.
+  bool Pop(BatchLine& line) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_empty_.wait(lock, [this]() { return closed_ || !lines_.empty(); });
+    if (lines_.empty()) {
+      return false;
+    }
+
+    line = std::move(lines_.front());
+    lines_.pop_front();
+    not_full_.notify_one();
+    return true;
+  }
+
+  void Close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    not_empty_.notify_all();
+  }
+
+ private:
+  size_t capacity_;
+  bool closed_;
+  std::deque<BatchLine> lines_;
+  std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+};
+
+// The JSON object for one line, without the trailing newline. The search
+// starts from an empty table so that its result depends on the line alone.
+std::string Analyze(const BatchLine& line, double time_limit, int max_depth,
+                    TranspositionTable& table, bool& valid) {
+  std::string fen;
+  std::string id;
+  std::ostringstream json;
+  json << "{\"index\":" << line.index;
+
+  valid = Batch::ParseEpd(line.text, fen, id);
+  if (!valid) {
+    json << ",\"error\":" << Batch::JsonString("not a position: " + line.text)
+         << "}";
+    return json.str();
+  }
+
+  FenParser parser;
+  State state;
+  FenError error;
+  if (!parser.Parse(fen, state, error)) {
+    valid = false;
+    json << ",\"error\":" << Batch::JsonString(error.message)
+         << ",\"column\":" << error.column
+         << ",\"fen\":" << Batch::JsonString(fen) << "}";
+    return json.str();
+  }
+
+  if (!id.empty()) {
+    json << ",\"id\":" << Batch::JsonString(id);
+  }
+
+  // Mate and stalemate have no move to search for.
+  if (ChessAI::Actions(state).empty()) {
+    bool mated = ChessAI::TerminalTest(state, PerceptSequence(state, 0)) ==
+                 kLoss;
+    json << ",\"bestmove\":\"0000\",\"result\":\""
+         << (mated ? "mate" : "stalemate")
+         << "\",\"depth\":0,\"nodes\":0,\"time\":0}";
+    return json.str();
+  }
+
+  std::unique_ptr<ChessAI> ai(new ChessAI(fen));
+  table.Clear();
+  ai->UseTable(table);
+
+  Timer timer;
+  timer.Start();
+  Action move = ai->Search(time_limit, max_depth);
+  timer.Stop();
+
+  json << ",\"bestmove\":\"" << UciProtocol::MoveToString(move) << "\"";
+
+  float value = ai->CompletedValue();
+  if (std::isinf(value)) {
+    json << ",\"mate\":" << (value > 0 ? 1 : -1);
+  } else {
+    json << ",\"score\":" << std::lround(value * 100);
+  }
+
+  char time[32];
+  std::snprintf(time, sizeof(time), "%.3f", timer.Elapsed());
+  json << ",\"depth\":" << ai->CompletedDepth()
+       << ",\"nodes\":" << ai->SearchedNodes() << ",\"time\":" << time;
+  if (kSearchStats) {
+    json << ",\"stats\":" << ai->SearchedStats().ToJson();
+  }
+  json << "}";
+  return json.str();
+}
+
+}  // namespace
+
+bool Batch::Run(std::istream& input, std::ostream& output, double time_limit,
+                int max_depth, int workers) {
+  BatchQueue queue(2 * static_cast<size_t>(workers));
+  std::mutex output_mutex;
+  bool all_valid = true;
+
+  // Each worker has a table as large as the shared one, so that workers
+  // neither race on it nor see each other's positions.
+  size_t megabytes =
+      std::max<size_t>(ChessAI::transposition_table_.SizeInBytes() >> 20, 1);
+
+  std::vector<std::thread> pool;
+  for (int i = 0; i < workers; i++) {
+    pool.emplace_back([&]() {
+      TranspositionTable table(megabytes);
+      BatchLine line;
+      while (queue.Pop(line)) {
+        bool valid;
+        std::string result =
+            Analyze(line, time_limit, max_depth, table, valid);
+
+        std::lock_guard<std::mutex> lock(output_mutex);
+        all_valid = all_valid && valid;
+        output << result << std::endl;
+      }
+    });
+  }
+
+  std::string text;
+  int index = 0;
+  while (std::getline(input, text)) {
+    index++;
+    size_t start = text.find_first_not_of(" \t\r");
+    if (start == std::string::npos || text[start] == '#') {
+      continue;
+    }
+    queue.Push({index, text});
+  }
+
+  queue.Close();
+  for (std::thread& worker : pool) {
+    worker.join();
+  }
+
+  return all_valid;
+}
+
+bool Batch::ParseEpd(const std::string& line, std::string& fen,
+                     std::string& id) {
+  std::istringstream fields(line);
+  std::string board, color, castling, en_passant;
+  if (!(fields >> board >> color >> castling >> en_passant)) {
+    return false;
+  }
+
+  fen = board + " " + color + " " + castling + " " + en_passant;
+  id.clear();
+
+  // A FEN goes on with the two move counters, an EPD with operations.
+  std::string rest;
+  std::getline(fields >> std::ws, rest);
+  std::istringstream counters(rest);
+  int half_moves, full_moves;
+  std::string extra;
+  if (counters >> half_moves >> full_moves && !(counters >> extra)) {
+    fen += " " + std::to_string(half_moves) + " " +
+           std::to_string(full_moves);
+    return true;
+  }
+  fen += " 0 1";
+
+  // Operations are "opcode operand...;", and id's operand is quoted.
+  size_t at = rest.find("id ");
+  while (at != std::string::npos && at > 0 && rest[at - 1] != ' ' &&
+         rest[at - 1] != ';') {
+    at = rest.find("id ", at + 1);
+  }
+  if (at != std::string::npos) {
+    size_t open = rest.find('"', at);
+    size_t close = open == std::string::npos ? open : rest.find('"', open + 1);
+    if (close != std::string::npos) {
+      id = rest.substr(open + 1, close - open - 1);
+    }
+  }
+
+  return true;
+}
+
+std::string Batch::JsonString(const std::string& line) {
+  std::string json = "\"";
+
+  for (unsigned char ch : line) {
+    if (ch == '"' || ch == '\\') {
+      json += '\\';
+      json += static_cast<char>(ch);
+    } else if (ch < 0x20) {
+      char escaped[8];
+      std::snprintf(escaped, sizeof(escaped), "\\u%04x", ch);
+      json += escaped;
+    } else {
+      json += static_cast<char>(ch);
+    }
+  }
+
+  return json + "\"";
+}
+
+}  // namespace ChessEngine
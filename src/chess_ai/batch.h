@@ -0,0 +1,52 @@
+//
+//  batch.h
+//  chess_ai
+//
+//  Created by Illya Starikov on 10/14/26.
+//  Copyright 2026. Illya Starikov. All rights reserved.
+//
+
+#ifndef CHESS_AI_BATCH_H_
+#define CHESS_AI_BATCH_H_
+
+#include <istream>
+#include <ostream>
+#include <string>
+
+namespace ChessEngine {
+
+// Offline analysis of many positions in one process. Lines of EPD or FEN
+// are read as they arrive and searched by a pool of workers. Workers do not
+// share the transposition table: each has one of its own, the size of the
+// shared one (--hash-mb), emptied before every position, so a result does
+// not depend on what else runs alongside it. Every result is written as
+// soon as it is known, as one JSON object per line:
+//   {"index":3,"id":"WAC.003","bestmove":"e2e4","score":31,"depth":9,
+//    "nodes":812734,"time":1.002}
+// index counts input lines from 1, so the input order can be restored.
+// Score is in centipawns for the side to move, and "mate":1 or -1 takes
+// its place when the side to move mates or gets mated. A position already
+// over has "bestmove":"0000" and "result":"mate" or "stalemate". A line
+// that is not EPD gets {"index":n,"error":"..."}; a FEN the parser
+// rejects adds the "column" it failed at in the "fen" it was given. Built
+// with make STATS=1, a "stats" object follows with the search counters.
+// Blank lines and lines starting with # are skipped.
+class Batch {
+ public:
+  // Searches each position for time_limit seconds or to max_depth,
+  // whichever comes first. Returns false if any line was not a position.
+  static bool Run(std::istream& input, std::ostream& output,
+                  double time_limit, int max_depth, int workers);
+
+  // Splits an EPD line into a FEN the parser takes and the id operation,
+  // if any. Plain FEN lines come back unchanged with an empty id.
+  static bool ParseEpd(const std::string& line, std::string& fen,
+                       std::string& id);
+
+  // line as a JSON string literal, quotes included.
+  static std::string JsonString(const std::string& line);
+};
+
+}  // namespace ChessEngine
+
+#endif  // CHESS_AI_BATCH_H_
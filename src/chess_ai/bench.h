@@ -0,0 +1,40 @@
+//
+//  bench.h
+//  chess_ai
+//
+//  Created by Illya Starikov on 10/14/26.
+//  Copyright 2026. Illya Starikov. All rights reserved.
+//
+
+#ifndef CHESS_AI_BENCH_H_
+#define CHESS_AI_BENCH_H_
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace ChessEngine {
+
+// Search speed checks: a fixed-depth search of built-in middlegame and
+// endgame positions, one thread and an empty table per position, so the
+// node counts only change when the search does. The signature hashes
+// every position's node count and best move; speed is only compared
+// between runs with the same depth and signature.
+//
+// A summary can be saved and later compared against as JSON:
+//   {"depth":8,"positions":40,"nodes":4311205,"nps":1234567,
+//    "signature":"9f86d081884c7d65"}
+class Bench {
+ public:
+  // Prints each position and the totals. With a baseline file, fails if
+  // the baseline searched a different depth or signature, or if nodes per
+  // second fell by more than max_regression, a fraction. With save_path,
+  // writes this run's summary there.
+  static bool Run(int depth, std::ostream& output,
+                  const std::string& baseline_path, double max_regression,
+                  const std::string& save_path);
+};
+
+}  // namespace ChessEngine
+
+#endif  // CHESS_AI_BENCH_H_
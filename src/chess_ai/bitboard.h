@@ -33,8 +33,8 @@ class Bitboard {
   Bitboard(const Bitboard& board) = default;
   Bitboard(Bitboard&& board) = default;
 
-  Bitboard& operator=(const Bitboard& right);
-  Bitboard& operator=(Bitboard&& right);
+  Bitboard& operator=(const Bitboard& right) = default;
+  Bitboard& operator=(Bitboard&& right) = default;
 
   bool operator==(const Bitboard& right) const noexcept;
   bool operator!=(const Bitboard& right) const noexcept;
@@ -51,10 +51,44 @@ class Bitboard {
   Bitboard& operator^=(const Bitboard& right) noexcept;
 
   std::vector<int> ToIndices() const;
-  Bitboard& FromIndex(int index);
+  Bitboard& FromIndex(int index) noexcept {
+    board_ = uint64_t{1} << index;
+    return *this;
+  }
+
+  // Index of the least significant set square. The board must not be empty.
+  int Lsb() const noexcept { return __builtin_ctzll(board_); }
+
+  // Clears the least significant set square and returns its index.
+  int PopLsb() noexcept {
+    int index = Lsb();
+    board_ &= board_ - 1;
+    return index;
+  }
 
-  std::vector<Bitboard> Separated() const;
-  int NumberOfBits() const noexcept;
+  int PopCount() const noexcept { return __builtin_popcountll(board_); }
+
+  // Visits the indices of the set squares, lowest first:
+  //   for (int square : bitboard) { ... }
+  class Iterator {
+   public:
+    explicit Iterator(uint64_t board) : board_(board) {}
+
+    int operator*() const noexcept { return __builtin_ctzll(board_); }
+    Iterator& operator++() noexcept {
+      board_ &= board_ - 1;
+      return *this;
+    }
+    bool operator!=(const Iterator& right) const noexcept {
+      return board_ != right.board_;
+    }
+
+   private:
+    uint64_t board_;
+  };
+
+  Iterator begin() const noexcept { return Iterator(board_); }
+  Iterator end() const noexcept { return Iterator(0); }
 
   std::bitset<64> GetRawBinary() const noexcept {
     return std::bitset<64>(board_);
@@ -12,24 +12,37 @@ namespace ChessEngine {
 
 // Initialize static worst_mode flag (for making AI pick worst moves).
 bool ChessAI::worst_mode_ = false;
+SearchAlgorithm ChessAI::search_algorithm_ = kPrincipalVariationSearch;
+
+TranspositionTable ChessAI::transposition_table_;
+int ChessAI::threads_ = 1;
+int ChessAI::clock_check_interval_ = 1024;
+NnueNetwork ChessAI::network_;
+PolyglotBook ChessAI::book_;
 
 ChessAI::ChessAI(const std::string& fen_string)
     : current_state_(parser_(fen_string)),
-      half_move_number_(2 * parser_.HalfMoves(fen_string)) {
-  history_.Add(current_state_);
-}
+      history_(current_state_, parser_.HalfMoves()),
+      time_remaining_(0),
+      increment_(0),
+      moves_to_go_(0),
+      half_move_number_(2 * (parser_.FullMoves() - 1) +
+                        current_state_.color_at_play_),
+      stop_(false),
+      completed_depth_(0),
+      completed_value_(0),
+      searched_nodes_(0),
+      table_(&transposition_table_) {}
 
 State ChessAI::InitialState() {
-  std::vector<Bitboard> white_bitboard(6);
-  std::vector<Bitboard> black_bitboard(6);
-  Bitboard all_whites(0xffff);
-  Bitboard all_blacks(0xffff000000000000);
+  PieceBoards white_bitboard;
+  PieceBoards black_bitboard;
   Bitboard en_passant_squares(0);
   Bitboard castling_squares = Bitboard(0x81) | Bitboard(0x8100000000000000);
 
   MoveEngine::GenerateInitialState(white_bitboard, black_bitboard);
-  return State(kWhite, all_whites, all_blacks, white_bitboard, black_bitboard,
-               en_passant_squares, castling_squares);
+  return State(kWhite, white_bitboard, black_bitboard, en_passant_squares,
+               castling_squares);
 }
 
 bool ChessAI::WasCapture(const Bitboard& enemy_bitboard, const Bitboard& move) {
@@ -37,15 +50,17 @@ bool ChessAI::WasCapture(const Bitboard& enemy_bitboard, const Bitboard& move) {
   return (enemy_bitboard & move) != kZeroBitboard;
 }
 
-Piece ChessAI::FindCapturePiece(const std::vector<Bitboard>& enemy_bitboards,
+Piece ChessAI::FindCapturePiece(const PieceBoards& pieces,
                                 const Bitboard& enemy_bitboard,
                                 const Bitboard& move) {
   if (!WasCapture(enemy_bitboard, move)) {
     return kKing;
   }
 
+  // The move lands on an enemy piece, so the shared board that holds it
+  // names the captured type.
   for (int i = 0; i < kNumberOfPieces; i++) {
-    if ((move & enemy_bitboards[i]) != Bitboard(0)) {
+    if ((move & pieces[i]) != Bitboard(0)) {
       return MoveEngine::IntToPiece(i);
     }
   }
@@ -97,278 +112,688 @@ Bitboard ChessAI::KingLocationAfterCastling(const Bitboard& rook_after) {
   return kZeroBitboard;
 }
 
-bool ChessAI::IsEightfoldRepetitionRule(const PerceptSequence& from_history) {
-  if (from_history.Size() < 8) {
-    return false;
-  }
+bool ChessAI::InsufficientMaterial(const State& current_state) {
+  const Bitboard kZeroBitboard(0);
+  const PieceBoards& pieces = current_state.pieces_;
 
-  for (int i = 0; i < 4; i++) {
-    if (from_history[i] != from_history[i + 4]) {
-      return false;
-    }
+  // King vs King, or King vs King + a single knight or bishop.
+  if ((pieces[MoveEngine::PieceToInt(kPawn)] |
+       pieces[MoveEngine::PieceToInt(kRook)] |
+       pieces[MoveEngine::PieceToInt(kQueen)]) != kZeroBitboard) {
+    return false;
   }
 
-  return from_history.MovesSincePawnMovement() >= 8 &&
-         from_history.MovesSinceCapture() >= 8;
-}
-
-bool ChessAI::InsufficientMaterial(const State& current_state) {
-  // King vs King
-  bool only_kings =
-      current_state.whites_[MoveEngine::PieceToInt(kRook)] == Bitboard(0) &&
-      current_state.whites_[MoveEngine::PieceToInt(kBishop)] == Bitboard(0) &&
-      current_state.whites_[MoveEngine::PieceToInt(kQueen)] == Bitboard(0) &&
-      current_state.whites_[MoveEngine::PieceToInt(kKnight)] == Bitboard(0) &&
-      current_state.whites_[MoveEngine::PieceToInt(kPawn)] == Bitboard(0) &&
-      current_state.blacks_[MoveEngine::PieceToInt(kRook)] == Bitboard(0) &&
-      current_state.blacks_[MoveEngine::PieceToInt(kBishop)] == Bitboard(0) &&
-      current_state.blacks_[MoveEngine::PieceToInt(kQueen)] == Bitboard(0) &&
-      current_state.blacks_[MoveEngine::PieceToInt(kKnight)] == Bitboard(0) &&
-      current_state.blacks_[MoveEngine::PieceToInt(kPawn)] == Bitboard(0);
-
-  // King vs King + Knight (black has knight)
-  bool king_vs_king_knight_black =
-      current_state.whites_[MoveEngine::PieceToInt(kRook)] == Bitboard(0) &&
-      current_state.whites_[MoveEngine::PieceToInt(kBishop)] == Bitboard(0) &&
-      current_state.whites_[MoveEngine::PieceToInt(kQueen)] == Bitboard(0) &&
-      current_state.whites_[MoveEngine::PieceToInt(kKnight)] == Bitboard(0) &&
-      current_state.whites_[MoveEngine::PieceToInt(kPawn)] == Bitboard(0) &&
-      current_state.blacks_[MoveEngine::PieceToInt(kRook)] == Bitboard(0) &&
-      current_state.blacks_[MoveEngine::PieceToInt(kBishop)] == Bitboard(0) &&
-      current_state.blacks_[MoveEngine::PieceToInt(kQueen)] == Bitboard(0) &&
-      current_state.blacks_[MoveEngine::PieceToInt(kKnight)].NumberOfBits() ==
-          1 &&
-      current_state.blacks_[MoveEngine::PieceToInt(kPawn)] == Bitboard(0);
-
-  // King vs King + Bishop (black has bishop)
-  bool king_vs_king_bishop_black =
-      current_state.whites_[MoveEngine::PieceToInt(kRook)] == Bitboard(0) &&
-      current_state.whites_[MoveEngine::PieceToInt(kBishop)] == Bitboard(0) &&
-      current_state.whites_[MoveEngine::PieceToInt(kQueen)] == Bitboard(0) &&
-      current_state.whites_[MoveEngine::PieceToInt(kKnight)] == Bitboard(0) &&
-      current_state.whites_[MoveEngine::PieceToInt(kPawn)] == Bitboard(0) &&
-      current_state.blacks_[MoveEngine::PieceToInt(kRook)] == Bitboard(0) &&
-      current_state.blacks_[MoveEngine::PieceToInt(kBishop)].NumberOfBits() ==
-          1 &&
-      current_state.blacks_[MoveEngine::PieceToInt(kQueen)] == Bitboard(0) &&
-      current_state.blacks_[MoveEngine::PieceToInt(kKnight)] == Bitboard(0) &&
-      current_state.blacks_[MoveEngine::PieceToInt(kPawn)] == Bitboard(0);
-
-  // King vs King + Knight (white has knight)
-  bool king_vs_king_knight_white =
-      current_state.whites_[MoveEngine::PieceToInt(kRook)] == Bitboard(0) &&
-      current_state.whites_[MoveEngine::PieceToInt(kBishop)] == Bitboard(0) &&
-      current_state.whites_[MoveEngine::PieceToInt(kQueen)] == Bitboard(0) &&
-      current_state.whites_[MoveEngine::PieceToInt(kKnight)].NumberOfBits() ==
-          1 &&
-      current_state.whites_[MoveEngine::PieceToInt(kPawn)] == Bitboard(0) &&
-      current_state.blacks_[MoveEngine::PieceToInt(kRook)] == Bitboard(0) &&
-      current_state.blacks_[MoveEngine::PieceToInt(kBishop)] == Bitboard(0) &&
-      current_state.blacks_[MoveEngine::PieceToInt(kQueen)] == Bitboard(0) &&
-      current_state.blacks_[MoveEngine::PieceToInt(kKnight)] == Bitboard(0) &&
-      current_state.blacks_[MoveEngine::PieceToInt(kPawn)] == Bitboard(0);
-
-  // King vs King + Bishop (white has bishop)
-  bool king_vs_king_bishop_white =
-      current_state.whites_[MoveEngine::PieceToInt(kRook)] == Bitboard(0) &&
-      current_state.whites_[MoveEngine::PieceToInt(kBishop)].NumberOfBits() ==
-          1 &&
-      current_state.whites_[MoveEngine::PieceToInt(kQueen)] == Bitboard(0) &&
-      current_state.whites_[MoveEngine::PieceToInt(kKnight)] == Bitboard(0) &&
-      current_state.whites_[MoveEngine::PieceToInt(kPawn)] == Bitboard(0) &&
-      current_state.blacks_[MoveEngine::PieceToInt(kRook)] == Bitboard(0) &&
-      current_state.blacks_[MoveEngine::PieceToInt(kBishop)] == Bitboard(0) &&
-      current_state.blacks_[MoveEngine::PieceToInt(kQueen)] == Bitboard(0) &&
-      current_state.blacks_[MoveEngine::PieceToInt(kKnight)] == Bitboard(0) &&
-      current_state.blacks_[MoveEngine::PieceToInt(kPawn)] == Bitboard(0);
-
-  return only_kings || king_vs_king_knight_black || king_vs_king_bishop_black ||
-         king_vs_king_knight_white || king_vs_king_bishop_white;
+  return (pieces[MoveEngine::PieceToInt(kKnight)] |
+          pieces[MoveEngine::PieceToInt(kBishop)])
+             .PopCount() <= 1;
 }
 
 bool ChessAI::FiftyMoveRule(const PerceptSequence& history) {
-  return history.MovesSinceCapture() >= 50 &&
-         history.MovesSincePawnMovement() > 50;
+  return history.HalfmoveClock() >= 100;
 }
 
-std::shared_ptr<Action> ChessAI::DepthLimitedMinimax(
-    int depth_limit, int quiescence_limit, double time_limit,
-    const State& state, std::map<Action, int>& history_table,
-    const PerceptSequence& history) {
+bool ChessAI::DepthLimitedMinimax(int depth_limit, int quiescence_limit,
+                                  double time_limit, const State& state,
+                                  SearchThread& thread, Action& best_action,
+                                  float& best_value) {
   Color friendly_color = state.color_at_play_;
   std::vector<Action> possible_actions = Actions(state);
 
+  // Every node below walks this one position with make/unmake.
+  State position = state;
+
   float alpha = -std::numeric_limits<float>::infinity();
   float beta = std::numeric_limits<float>::infinity();
 
-  Action best_action = possible_actions.back();
-  std::shared_ptr<float> current_max_value =
-      MinValue(depth_limit - 1, quiescence_limit, time_limit,
-               Result(state, best_action), best_action, alpha, beta,
-               friendly_color, history_table, history);
-
-  possible_actions.pop_back();
+  float max_value = -std::numeric_limits<float>::infinity();
+  bool searched_any = false;
 
   for (const Action& action : possible_actions) {
-    std::shared_ptr<float> value =
-        MinValue(depth_limit - 1, quiescence_limit, time_limit,
-                 Result(state, action), action, alpha, beta, friendly_color,
-                 history_table, history);
-    if (value == nullptr) {
-      return nullptr;
+    Undo undo = MakeMove(position, action);
+    thread.history.Add(position, action);
+    thread.accumulators.Push(position, action, undo);
+    float value =
+        MinValue(depth_limit - 1, quiescence_limit, time_limit, position,
+                 alpha, beta, friendly_color, thread, 1);
+    UnmakeMove(position, action, undo);
+    thread.history.Pop();
+    thread.accumulators.Pop();
+
+    if (ShouldStop(thread, time_limit)) {
+      return false;
     }
 
-    if (value > current_max_value) {
-      current_max_value = value;
+    // Ties go to the earlier action, so the choice depends only on the
+    // scores.
+    if (!searched_any || value > max_value) {
+      max_value = value;
       best_action = action;
+      searched_any = true;
     }
   }
 
-  return std::make_shared<Action>(best_action);
+  best_value = max_value;
+  return searched_any;
 }
 
-std::shared_ptr<float> ChessAI::MaxValue(int depth_limit, int quiescence_limit,
-                                         double time_limit, const State& state,
-                                         const Action& action, float alpha,
-                                         float beta, Color color,
-                                         std::map<Action, int>& history_table,
-                                         const PerceptSequence& history) {
-  if (TerminalTest(state, history) != kNonterminal) {
-    return std::make_shared<float>(UtilityFunction(state, color, history));
+float ChessAI::MaxValue(int depth_limit, int quiescence_limit,
+                        double time_limit, State& state, float alpha,
+                        float beta, Color color, SearchThread& thread,
+                        int ply) {
+  thread.nodes++;
+  if (IsDrawn(state, thread.history)) {
+    return 0;
   }
-  if (move_timer_.Elapsed() > time_limit) {
-    return nullptr;
+  if (ShouldStop(thread, time_limit)) {
+    return 0;
   }
-  if (depth_limit <= 0 && IsNonQuiescenceState(action)) {
-    quiescence_limit--;
-  } else if (depth_limit <= 0) {
-    return std::make_shared<float>(UtilityHeuristic(state, color));
+  if (depth_limit <= 0) {
+    // Quiescence stands pat, so a mate on the horizon is caught here.
+    if (InCheck(state) && !HasLegalAction(state)) {
+      return NoActionUtility(state, color);
+    }
+    return Quiescence(quiescence_limit, state, alpha, beta, thread, ply);
   }
 
-  std::vector<Action> possible_actions = Actions(state);
-  auto sort_function = [&](const Action& action1, const Action& action2) {
-    int val1 = (history_table.find(action1) != history_table.end())
-                   ? history_table[action1]
-                   : 0;
-    int val2 = (history_table.find(action2) != history_table.end())
-                   ? history_table[action2]
-                   : 0;
-    return val1 > val2;
-  };
-  std::sort(possible_actions.begin(), possible_actions.end(), sort_function);
+  float table_value;
+  Action table_move(0);
+  if (ProbeTransposition(state, depth_limit, alpha, beta, color, thread,
+                         table_value, table_move)) {
+    return table_value;
+  }
+  float tablebase_value;
+  if (TablebaseUtility(state, color, ply, tablebase_value)) {
+    return tablebase_value;
+  }
+  float alpha_before = alpha;
+  float beta_before = beta;
 
   float value = -std::numeric_limits<float>::infinity();
-  Action best_action;
+  Action best_action(0);
+  int moves_searched = 0;
+
+  MovePicker picker(state, thread.move_history, ply, table_move,
+                    thread.move_buffers[ply]);
+  Action act;
+  while (NextAction(picker, act, thread)) {
+    moves_searched++;
+    Undo undo = MakeMove(state, act, thread);
+    thread.history.Add(state, act);
+    thread.accumulators.Push(state, act, undo);
+
+    float new_value =
+        MinValue(depth_limit - 1, quiescence_limit, time_limit, state, alpha,
+                 beta, color, thread, ply + 1);
+    UnmakeMove(state, act, undo, thread);
+    thread.history.Pop();
+    thread.accumulators.Pop();
+
+    // A stopped child's score is meaningless, and must not reach the
+    // table.
+    if (ShouldStop(thread, time_limit)) {
+      return value;
+    }
 
-  for (const Action& act : possible_actions) {
-    PerceptSequence new_history = history;
-    State resultant_state = Result(state, act);
+    if (new_value > value) {
+      value = new_value;
+      best_action = act;
+    }
+
+    if (value >= beta) {
+      if (kSearchStats) {
+        thread.stats.AddCutoff(moves_searched - 1);
+      }
+      if (!MovePicker::IsNoisy(act)) {
+        thread.move_history.AddCutoff(act, ply, depth_limit);
+      }
+      StoreTransposition(state, depth_limit, value, alpha_before, beta_before,
+                         act, color);
+      return value;
+    }
+
+    alpha = std::max(alpha, value);
+  }
+
+  if (moves_searched == 0) {
+    return NoActionUtility(state, color);
+  }
+  StoreTransposition(state, depth_limit, value, alpha_before, beta_before,
+                     best_action, color);
+  return value;
+}
 
-    new_history.Add(resultant_state);
-    new_history.Add(act);
+float ChessAI::MinValue(int depth_limit, int quiescence_limit,
+                        double time_limit, State& state, float alpha,
+                        float beta, Color color, SearchThread& thread,
+                        int ply) {
+  thread.nodes++;
+  if (IsDrawn(state, thread.history)) {
+    return 0;
+  }
+  if (ShouldStop(thread, time_limit)) {
+    return 0;
+  }
+  if (depth_limit <= 0) {
+    // Quiescence stands pat, so a mate on the horizon is caught here.
+    if (InCheck(state) && !HasLegalAction(state)) {
+      return NoActionUtility(state, color);
+    }
+    return -Quiescence(quiescence_limit, state, -beta, -alpha, thread, ply);
+  }
 
-    std::shared_ptr<float> new_value =
-        MinValue(depth_limit - 1, quiescence_limit, time_limit, resultant_state,
-                 act, alpha, beta, color, history_table, new_history);
+  float table_value;
+  Action table_move(0);
+  if (ProbeTransposition(state, depth_limit, alpha, beta, color, thread,
+                         table_value, table_move)) {
+    return table_value;
+  }
+  float tablebase_value;
+  if (TablebaseUtility(state, color, ply, tablebase_value)) {
+    return tablebase_value;
+  }
+  float alpha_before = alpha;
+  float beta_before = beta;
 
-    if (new_value == nullptr) {
-      return nullptr;
+  float value = std::numeric_limits<float>::infinity();
+  Action best_action(0);
+  int moves_searched = 0;
+
+  MovePicker picker(state, thread.move_history, ply, table_move,
+                    thread.move_buffers[ply]);
+  Action act;
+  while (NextAction(picker, act, thread)) {
+    moves_searched++;
+    Undo undo = MakeMove(state, act, thread);
+    thread.history.Add(state, act);
+    thread.accumulators.Push(state, act, undo);
+
+    float new_value =
+        MaxValue(depth_limit - 1, quiescence_limit, time_limit, state, alpha,
+                 beta, color, thread, ply + 1);
+    UnmakeMove(state, act, undo, thread);
+    thread.history.Pop();
+    thread.accumulators.Pop();
+
+    // A stopped child's score is meaningless, and must not reach the
+    // table.
+    if (ShouldStop(thread, time_limit)) {
+      return value;
     }
 
-    if (*new_value > value) {
-      value = *new_value;
+    if (new_value < value) {
+      value = new_value;
       best_action = act;
     }
 
-    if (value >= beta) {
-      AddToHistoryTable(history_table, act);
-      return std::make_shared<float>(value);
+    if (value <= alpha) {
+      if (kSearchStats) {
+        thread.stats.AddCutoff(moves_searched - 1);
+      }
+      if (!MovePicker::IsNoisy(act)) {
+        thread.move_history.AddCutoff(act, ply, depth_limit);
+      }
+      StoreTransposition(state, depth_limit, value, alpha_before, beta_before,
+                         act, color);
+      return value;
     }
 
-    alpha = std::max(alpha, value);
+    beta = std::min(beta, value);
   }
 
-  AddToHistoryTable(history_table, best_action);
-  return std::make_shared<float>(value);
+  if (moves_searched == 0) {
+    return NoActionUtility(state, color);
+  }
+  StoreTransposition(state, depth_limit, value, alpha_before, beta_before,
+                     best_action, color);
+  return value;
 }
 
-std::shared_ptr<float> ChessAI::MinValue(int depth_limit, int quiescence_limit,
-                                         double time_limit, const State& state,
-                                         const Action& action, float alpha,
-                                         float beta, Color color,
-                                         std::map<Action, int>& history_table,
-                                         const PerceptSequence& history) {
-  if (TerminalTest(state, history) != kNonterminal) {
-    return std::make_shared<float>(UtilityFunction(state, color, history));
+bool ChessAI::AspirationSearch(int depth_limit, int quiescence_limit,
+                               double time_limit, const State& state,
+                               float previous_value, SearchThread& thread,
+                               Action& best_action, float& best_value) {
+  const float kInfinity = std::numeric_limits<float>::infinity();
+  // Half a pawn either side of the last score, doubled on every miss and
+  // dropped once it passes a few pawns.
+  const float kInitialWindow = 0.5f;
+  const float kWidestWindow = 4.0f;
+  const int kAspirationMinDepth = 4;
+
+  float window = kInitialWindow;
+  float alpha = -kInfinity;
+  float beta = kInfinity;
+  if (depth_limit >= kAspirationMinDepth && std::isfinite(previous_value)) {
+    alpha = previous_value - window;
+    beta = previous_value + window;
   }
-  if (move_timer_.Elapsed() > time_limit) {
-    return nullptr;
+
+  // Every node below walks this one position with make/unmake.
+  State position = state;
+
+  while (true) {
+    Action move = best_action;
+    float value;
+    if (!PrincipalVariationRoot(depth_limit, quiescence_limit, time_limit,
+                                position, alpha, beta, thread,
+                                move, value)) {
+      return false;
+    }
+
+    window *= 2;
+    if (value <= alpha && alpha > -kInfinity) {
+      alpha = window > kWidestWindow ? -kInfinity : value - window;
+    } else if (value >= beta && beta < kInfinity) {
+      beta = window > kWidestWindow ? kInfinity : value + window;
+      best_action = move;
+    } else {
+      best_action = move;
+      best_value = value;
+      return true;
+    }
   }
-  if (depth_limit <= 0 && IsNonQuiescenceState(action)) {
-    quiescence_limit--;
-  } else if (depth_limit <= 0) {
-    return std::make_shared<float>(UtilityHeuristic(state, color));
+}
+
+bool ChessAI::PrincipalVariationRoot(int depth_limit, int quiescence_limit,
+                                     double time_limit, State& state,
+                                     float alpha, float beta,
+                                     SearchThread& thread,
+                                     Action& best_action, float& best_value) {
+  Color color = state.color_at_play_;
+
+  // The previous iteration's best move goes first, or the table's.
+  Action table_move = best_action;
+  TranspositionEntry entry;
+  if (table_move.Key() == 0 &&
+      table_->Probe(state.key_, entry)) {
+    table_move = entry.move;
   }
 
-  std::vector<Action> possible_actions = Actions(state);
-  auto sort_function = [&](const Action& action1, const Action& action2) {
-    int val1 = (history_table.find(action1) != history_table.end())
-                   ? history_table[action1]
-                   : 0;
-    int val2 = (history_table.find(action2) != history_table.end())
-                   ? history_table[action2]
-                   : 0;
-    return val1 > val2;
-  };
-
-  std::sort(possible_actions.begin(), possible_actions.end(), sort_function);
+  float alpha_before = alpha;
+  float value = -std::numeric_limits<float>::infinity();
+  int moves_searched = 0;
+
+  MovePicker picker(state, thread.move_history, 0, table_move,
+                    thread.move_buffers[0]);
+  Action act;
+  while (NextAction(picker, act, thread)) {
+    Undo undo = MakeMove(state, act, thread);
+    thread.history.Add(state, act);
+    thread.accumulators.Push(state, act, undo);
+
+    float new_value;
+    if (moves_searched == 0) {
+      new_value = -PrincipalVariation(depth_limit - 1, quiescence_limit,
+                                      time_limit, state, -beta, -alpha, true,
+                                      thread, 1);
+    } else {
+      float above_alpha = NullWindowAbove(alpha);
+      new_value = -PrincipalVariation(depth_limit - 1, quiescence_limit,
+                                      time_limit, state, -above_alpha, -alpha,
+                                      true, thread, 1);
+      if (new_value > alpha && new_value < beta) {
+        new_value = -PrincipalVariation(depth_limit - 1, quiescence_limit,
+                                        time_limit, state, -beta, -alpha, true,
+                                        thread, 1);
+      }
+    }
+    UnmakeMove(state, act, undo, thread);
+    thread.history.Pop();
+    thread.accumulators.Pop();
 
-  float value = std::numeric_limits<float>::infinity();
-  Action best_action;
+    if (ShouldStop(thread, time_limit)) {
+      return false;
+    }
+
+    if (moves_searched++ == 0 || new_value > value) {
+      value = new_value;
+      best_action = act;
+    }
+
+    if (value >= beta) {
+      if (kSearchStats) {
+        thread.stats.AddCutoff(moves_searched - 1);
+      }
+      break;
+    }
+    alpha = std::max(alpha, value);
+  }
+
+  StoreTransposition(state, depth_limit, value, alpha_before, beta,
+                     best_action, color);
+  best_value = value;
+  return true;
+}
+
+float ChessAI::PrincipalVariation(int depth_limit, int quiescence_limit,
+                                  double time_limit, State& state, float alpha,
+                                  float beta, bool allow_null_move,
+                                  SearchThread& thread, int ply) {
+  const float kInfinity = std::numeric_limits<float>::infinity();
+  const int kNullMoveMinDepth = 3;
+  const int kReductionMinDepth = 3;
+  const int kReductionMinMoves = 3;
+
+  Color color = state.color_at_play_;
+
+  thread.nodes++;
+  if (IsDrawn(state, thread.history)) {
+    return 0;
+  }
+  if (ShouldStop(thread, time_limit)) {
+    return 0;
+  }
+  if (depth_limit <= 0) {
+    // Quiescence stands pat, so a mate on the horizon is caught here.
+    if (InCheck(state) && !HasLegalAction(state)) {
+      return NoActionUtility(state, color);
+    }
+    return Quiescence(quiescence_limit, state, alpha, beta, thread, ply);
+  }
 
-  for (const Action& act : possible_actions) {
-    PerceptSequence new_history = history;
-    State resultant_state = Result(state, act);
+  float table_value;
+  Action table_move(0);
+  if (ProbeTransposition(state, depth_limit, alpha, beta, color, thread,
+                         table_value, table_move)) {
+    return table_value;
+  }
+  float tablebase_value;
+  if (TablebaseUtility(state, color, ply, tablebase_value)) {
+    return tablebase_value;
+  }
 
-    new_history.Add(resultant_state);
-    new_history.Add(act);
+  bool in_check = InCheck(state);
+
+  // Null move: if passing still fails high after a shallower search, a
+  // real move almost surely would too. Passing is never legal in check,
+  // and with only pawns left it may be the best move (zugzwang), so those
+  // positions are searched normally.
+  if (allow_null_move && !in_check && depth_limit >= kNullMoveMinDepth &&
+      beta < kInfinity && HasNonPawnMaterial(state) &&
+      UtilityHeuristic(state, color, thread) >= beta) {
+    int reduction = depth_limit >= 6 ? 3 : 2;
+
+    Undo undo = MakeNullMove(state);
+    thread.history.AddNullMove(state);
+    thread.accumulators.PushNullMove();
+    float null_value = -PrincipalVariation(
+        depth_limit - 1 - reduction, quiescence_limit, time_limit, state,
+        -beta, -NullWindowAbove(-beta), false, thread, ply + 1);
+    UnmakeNullMove(state, undo);
+    thread.history.Pop();
+    thread.accumulators.Pop();
+
+    if (ShouldStop(thread, time_limit)) {
+      return 0;
+    }
+    if (null_value >= beta) {
+      return beta;
+    }
+  }
 
-    std::shared_ptr<float> new_value =
-        MaxValue(depth_limit - 1, quiescence_limit, time_limit, resultant_state,
-                 act, alpha, beta, color, history_table, new_history);
+  float alpha_before = alpha;
+  float value = -kInfinity;
+  Action best_action(0);
+  int moves_searched = 0;
+
+  MovePicker picker(state, thread.move_history, ply, table_move,
+                    thread.move_buffers[ply]);
+  Action act;
+  while (NextAction(picker, act, thread)) {
+    Undo undo = MakeMove(state, act, thread);
+    thread.history.Add(state, act);
+    thread.accumulators.Push(state, act, undo);
+
+    float new_value;
+    if (moves_searched == 0) {
+      new_value = -PrincipalVariation(depth_limit - 1, quiescence_limit,
+                                      time_limit, state, -beta, -alpha, true,
+                                      thread, ply + 1);
+    } else {
+      // Late quiet moves rarely matter, so they first get a shallower look.
+      int reduction = 0;
+      if (moves_searched >= kReductionMinMoves &&
+          depth_limit >= kReductionMinDepth && !in_check &&
+          !MovePicker::IsNoisy(act) && !InCheck(state)) {
+        reduction = moves_searched >= 6 && depth_limit >= 6 ? 2 : 1;
+      }
+
+      float above_alpha = NullWindowAbove(alpha);
+      new_value = -PrincipalVariation(
+          depth_limit - 1 - reduction, quiescence_limit, time_limit, state,
+          -above_alpha, -alpha, true, thread, ply + 1);
+      if (new_value > alpha && reduction > 0) {
+        new_value = -PrincipalVariation(
+            depth_limit - 1, quiescence_limit, time_limit, state, -above_alpha,
+            -alpha, true, thread, ply + 1);
+      }
+      if (new_value > alpha && new_value < beta) {
+        new_value = -PrincipalVariation(depth_limit - 1, quiescence_limit,
+                                        time_limit, state, -beta, -alpha, true,
+                                        thread, ply + 1);
+      }
+    }
+    UnmakeMove(state, act, undo, thread);
+    thread.history.Pop();
+    thread.accumulators.Pop();
+    moves_searched++;
 
-    if (new_value == nullptr) {
-      return nullptr;
+    if (ShouldStop(thread, time_limit)) {
+      return 0;
     }
 
-    if (*new_value < value) {
-      value = *new_value;
+    if (new_value > value) {
+      value = new_value;
       best_action = act;
     }
 
-    if (value <= alpha) {
-      AddToHistoryTable(history_table, act);
-      return std::make_shared<float>(value);
+    if (value >= beta) {
+      if (kSearchStats) {
+        thread.stats.AddCutoff(moves_searched - 1);
+      }
+      if (!MovePicker::IsNoisy(act)) {
+        thread.move_history.AddCutoff(act, ply, depth_limit);
+      }
+      StoreTransposition(state, depth_limit, value, alpha_before, beta, act,
+                         color);
+      return value;
     }
 
-    beta = std::min(beta, value);
+    alpha = std::max(alpha, value);
+  }
+
+  // Checkmate or stalemate.
+  if (moves_searched == 0) {
+    return NoActionUtility(state, color);
+  }
+  StoreTransposition(state, depth_limit, value, alpha_before, beta,
+                     best_action, color);
+  return value;
+}
+
+Undo ChessAI::MakeNullMove(State& state) {
+  Undo undo{state.en_passant_squares_, state.castling_squares_, Bitboard(0),
+            state.key_, state.pawn_key_, state.psqt_, state.phase_};
+
+  state.key_ ^= Zobrist::EnPassantKeys(state.en_passant_squares_) ^
+                Zobrist::SideKey();
+  state.en_passant_squares_ = Bitboard(0);
+  state.color_at_play_ = static_cast<Color>((state.color_at_play_ + 1) % 2);
+
+  return undo;
+}
+
+void ChessAI::UnmakeNullMove(State& state, const Undo& undo) {
+  state.color_at_play_ = static_cast<Color>((state.color_at_play_ + 1) % 2);
+  state.en_passant_squares_ = undo.en_passant_squares;
+  state.key_ = undo.key;
+}
+
+bool ChessAI::InCheck(const State& state) {
+  Color friendly_color = state.color_at_play_;
+  Color enemy_color = static_cast<Color>((friendly_color + 1) % 2);
+
+  Bitboard king = state.Pieces(friendly_color, kKing);
+  return king != Bitboard(0) &&
+         MoveEngine::IsSquareAttacked(king.Lsb(), enemy_color, state.pieces_,
+                                      state.Occupancy(enemy_color),
+                                      state.AllPieces());
+}
+
+bool ChessAI::HasNonPawnMaterial(const State& state) {
+  Bitboard pawns_and_kings = state.pieces_[MoveEngine::PieceToInt(kPawn)] |
+                             state.pieces_[MoveEngine::PieceToInt(kKing)];
+  return (state.Occupancy(state.color_at_play_) & ~pawns_and_kings) !=
+         Bitboard(0);
+}
+
+bool ChessAI::ProbeTransposition(const State& state, int depth, float alpha,
+                                 float beta, Color color, SearchThread& thread,
+                                 float& value, Action& table_move) {
+  TranspositionEntry entry;
+  bool hit = table_->Probe(state.key_, entry);
+  if (kSearchStats) {
+    thread.stats.table_probes++;
+    thread.stats.table_hits += hit;
+  }
+  if (!hit) {
+    return false;
+  }
+
+  table_move = entry.move;
+  if (entry.depth < depth) {
+    return false;
+  }
+
+  value = entry.score;
+  Bound bound = entry.bound;
+  if (state.color_at_play_ != color) {
+    value = -value;
+    bound = OpponentBound(bound);
   }
 
-  AddToHistoryTable(history_table, best_action);
-  return std::make_shared<float>(value);
+  return bound == kExactBound || (bound == kLowerBound && value >= beta) ||
+         (bound == kUpperBound && value <= alpha);
 }
 
-void ChessAI::AddToHistoryTable(std::map<Action, int>& history_table,
-                                const Action& action) {
-  if (history_table.find(action) == history_table.end()) {
-    history_table[action] = 0;
+void ChessAI::StoreTransposition(const State& state, int depth, float value,
+                                 float alpha, float beta,
+                                 const Action& best_action, Color color) {
+  Bound bound = value <= alpha  ? kUpperBound
+                : value >= beta ? kLowerBound
+                                : kExactBound;
+  if (state.color_at_play_ != color) {
+    value = -value;
+    bound = OpponentBound(bound);
   }
-  history_table[action]++;
+
+  table_->Store(state.key_, {value, best_action, depth, bound});
 }
 
-Bitboard ChessAI::CastlingMoveGenerator(const Bitboard& all_whites,
-                                        const Bitboard& all_blacks,
-                                        const Bitboard& castling_squares,
+float ChessAI::Quiescence(int quiescence_limit, State& state, float alpha,
+                          float beta, SearchThread& thread, int ply) {
+  float value = UtilityHeuristic(state, state.color_at_play_, thread);
+  if (value >= beta || quiescence_limit <= 0) {
+    return value;
+  }
+  alpha = std::max(alpha, value);
+
+  MovePicker picker(state, thread.move_buffers[ply]);
+  Action act;
+  while (NextAction(picker, act, thread)) {
+    Undo undo = MakeMove(state, act, thread);
+    thread.accumulators.Push(state, act, undo);
+    // The search counted the node quiescence starts from.
+    thread.nodes++;
+    if (kSearchStats) {
+      thread.stats.quiescence_nodes++;
+    }
+    float new_value = -Quiescence(quiescence_limit - 1, state, -beta, -alpha,
+                                  thread, ply + 1);
+    UnmakeMove(state, act, undo, thread);
+    thread.accumulators.Pop();
+
+    if (new_value > value) {
+      value = new_value;
+      if (value >= beta) {
+        return value;
+      }
+      alpha = std::max(alpha, value);
+    }
+  }
+
+  return value;
+}
+
+int ChessAI::StaticExchange(const State& state, const Action& action) {
+  // Cheapest attacker first; the king only recaptures last.
+  const Piece kAttackerOrder[] = {kPawn, kKnight, kBishop, kRook, kQueen,
+                                  kKing};
+
+  const int square = action.To();
+  const PieceBoards& pieces = state.pieces_;
+
+  Bitboard occupancy = state.AllPieces() & ~action.PieceBefore();
+  if (action.WasEnPassantCapture()) {
+    occupancy &= ~state.en_passant_squares_;
+  }
+
+  // gains[i] is what the side making capture i nets if the exchange stops
+  // right after it.
+  int gains[2 * kNumberOfPieces * 8];
+  int depth = 0;
+
+  gains[0] = 0;
+  if (action.WasCapture()) {
+    gains[0] = kPieceValues[action.PieceCaptured()];
+  } else if (action.WasEnPassantCapture()) {
+    gains[0] = kPieceValues[kPawn];
+  }
+
+  Piece on_square = action.GetPiece();
+  if (action.WasPromotion()) {
+    on_square = action.PromotedTo();
+    gains[0] += kPieceValues[on_square] - kPieceValues[kPawn];
+  }
+
+  Color side = static_cast<Color>((action.GetColor() + 1) % 2);
+  Bitboard attackers = MoveEngine::AttackersTo(
+      square, pieces, state.all_whites_, state.all_blacks_, occupancy);
+
+  while (true) {
+    Bitboard side_attackers = attackers & state.Occupancy(side);
+    if (side_attackers == Bitboard(0)) {
+      break;
+    }
+
+    Piece attacker = kKing;
+    Bitboard attacker_board;
+    for (Piece piece : kAttackerOrder) {
+      attacker_board = side_attackers & pieces[MoveEngine::PieceToInt(piece)];
+      if (attacker_board != Bitboard(0)) {
+        attacker = piece;
+        break;
+      }
+    }
+
+    depth++;
+    gains[depth] = kPieceValues[on_square] - gains[depth - 1];
+
+    occupancy &= ~Bitboard().FromIndex(attacker_board.Lsb());
+    attackers = MoveEngine::AttackersTo(square, pieces, state.all_whites_,
+                                        state.all_blacks_, occupancy);
+    on_square = attacker;
+    side = static_cast<Color>((side + 1) % 2);
+  }
+
+  // Each side only recaptures when that beats stopping.
+  for (; depth > 0; depth--) {
+    gains[depth - 1] = -std::max(-gains[depth - 1], gains[depth]);
+  }
+
+  return gains[0];
+}
+
+Bitboard ChessAI::CastlingMoveGenerator(const State& state,
                                         const Bitboard& rook) {
   const Bitboard kZeroBitboard(0);
 
@@ -382,8 +807,12 @@ Bitboard ChessAI::CastlingMoveGenerator(const Bitboard& all_whites,
   const Bitboard kBlackLongSideAfter(0x800000000000000);
   const Bitboard kBlackShortSideAfter(0x2000000000000000);
 
-  Bitboard possible_castles =
-      MoveEngine::CastlingMoves(castling_squares, all_whites, all_blacks);
+  Color friendly_color = state.color_at_play_;
+  Color enemy_color = static_cast<Color>((friendly_color + 1) % 2);
+
+  Bitboard possible_castles = MoveEngine::CastlingMoves(
+      state.castling_squares_, state.pieces_, state.Occupancy(friendly_color),
+      state.Occupancy(enemy_color), friendly_color);
   Bitboard to_return = kZeroBitboard;
 
   if ((kWhiteLongSideBefore & possible_castles & rook) != kZeroBitboard) {
@@ -403,6 +832,187 @@ Bitboard ChessAI::CastlingMoveGenerator(const Bitboard& all_whites,
 }
 
 std::vector<Action> ChessAI::Actions(const State& state) {
+  MoveList moves;
+  GenerateActions(state, kAllMoves, moves);
+  return std::vector<Action>(moves.begin(), moves.end());
+}
+
+void ChessAI::GenerateActions(const State& state, MoveStage stage,
+                              MoveList& moves) {
+  const Bitboard kZeroBitboard(0);
+  const Bitboard kFirstEighthRank(0xff000000000000ff);
+
+  Color friendly_color = state.color_at_play_;
+  Color enemy_color = static_cast<Color>((state.color_at_play_ + 1) % 2);
+
+  const Bitboard& all_friendly = state.Occupancy(friendly_color);
+  const Bitboard& all_enemy = state.Occupancy(enemy_color);
+  const Bitboard occupancy = all_friendly | all_enemy;
+  const Bitboard empty = ~occupancy;
+
+  bool noisy = stage != kQuietMoves;
+  bool quiet = stage != kNoisyMoves;
+
+  // Squares a non-pawn move may land on in this stage.
+  Bitboard targets = (noisy ? all_enemy : kZeroBitboard) |
+                     (quiet ? empty : kZeroBitboard);
+
+  // Checks and pins are found once per position, so that apart from the
+  // king's own moves and en passant every move generated is legal as is.
+  // In check, a move must capture the checker or block it; against two
+  // checkers only the king can move.
+  Bitboard king = state.Pieces(friendly_color, kKing);
+  int king_square = king != kZeroBitboard ? king.Lsb() : 0;
+  Bitboard checkers;
+  Bitboard pinned;
+  Bitboard evasions = ~kZeroBitboard;
+  if (king != kZeroBitboard) {
+    checkers = MoveEngine::AttackersTo(king_square, state.pieces_,
+                                       state.all_whites_, state.all_blacks_,
+                                       occupancy) &
+               all_enemy;
+    pinned = MoveEngine::PinnedPieces(king_square, state.pieces_, all_friendly,
+                                      all_enemy);
+
+    if (checkers.PopCount() == 1) {
+      evasions = checkers | AttackTables::Between(king_square, checkers.Lsb());
+    } else if (checkers != kZeroBitboard) {
+      evasions = kZeroBitboard;
+    }
+  }
+
+  // The king is lifted off the board for its own test, so a slider checking
+  // it along a line also covers the square behind it.
+  for (int to : MoveEngine::KingMoves(king, all_friendly) & targets) {
+    if (!MoveEngine::IsSquareAttacked(to, enemy_color, state.pieces_,
+                                      all_enemy, occupancy & ~king)) {
+      AddActions(state, kKing, king, Bitboard().FromIndex(to), false, false,
+                 moves);
+    }
+  }
+
+  for (Piece piece : {kKnight, kRook, kBishop, kQueen}) {
+    for (int from : state.Pieces(friendly_color, piece)) {
+      Bitboard before = Bitboard().FromIndex(from);
+
+      Bitboard destinations;
+      switch (piece) {
+        case kKnight:
+          destinations = MoveEngine::KnightMoves(before, all_friendly);
+          break;
+        case kRook:
+          destinations = MoveEngine::RookMoves(before, all_friendly, all_enemy);
+          break;
+        case kBishop:
+          destinations =
+              MoveEngine::BishopMoves(before, all_friendly, all_enemy);
+          break;
+        default:
+          destinations =
+              MoveEngine::QueenMoves(before, all_friendly, all_enemy);
+          break;
+      }
+      destinations &= targets & evasions;
+      if ((pinned & before) != kZeroBitboard) {
+        destinations &= AttackTables::Line(king_square, from);
+      }
+
+      for (int to : destinations) {
+        AddActions(state, piece, before, Bitboard().FromIndex(to), false,
+                   false, moves);
+      }
+    }
+  }
+
+  // Pawn captures and promotions are noisy, every other push is quiet.
+  for (int from : state.Pieces(friendly_color, kPawn)) {
+    Bitboard before = Bitboard().FromIndex(from);
+    Bitboard destinations =
+        MoveEngine::PawnMoves(before, all_friendly, all_enemy, friendly_color);
+
+    Bitboard pushes = destinations & empty;
+    Bitboard wanted =
+        (noisy ? (destinations & all_enemy) | (pushes & kFirstEighthRank)
+               : kZeroBitboard) |
+        (quiet ? pushes & ~kFirstEighthRank : kZeroBitboard);
+    wanted &= evasions;
+    if ((pinned & before) != kZeroBitboard) {
+      wanted &= AttackTables::Line(king_square, from);
+    }
+
+    for (int to : wanted) {
+      AddActions(state, kPawn, before, Bitboard().FromIndex(to), false, false,
+                 moves);
+    }
+
+    // En passant removes two pawns from one rank at once, which can uncover
+    // a check no pin accounts for, so it keeps the full test.
+    if (noisy) {
+      Bitboard en_passant = EnpassantMoveGenerator(state.en_passant_squares_,
+                                                   before, friendly_color);
+      for (int to : en_passant) {
+        AddIfLegal(state, kPawn, before, Bitboard().FromIndex(to), true, false,
+                   moves);
+      }
+    }
+  }
+
+  // CastlingMoves already keeps the king off attacked squares.
+  if (quiet && checkers == kZeroBitboard) {
+    Bitboard rooks =
+        state.Pieces(friendly_color, kRook) & state.castling_squares_;
+    for (int from : rooks) {
+      Bitboard before = Bitboard().FromIndex(from);
+      for (int to : CastlingMoveGenerator(state, before)) {
+        AddActions(state, kRook, before, Bitboard().FromIndex(to), false, true,
+                   moves);
+      }
+    }
+  }
+}
+
+void ChessAI::AddIfLegal(const State& state, Piece piece,
+                         const Bitboard& before, const Bitboard& after,
+                         bool is_en_passant, bool is_castling,
+                         MoveList& moves) {
+  const Bitboard kZeroBitboard(0);
+
+  Color friendly_color = state.color_at_play_;
+  Color enemy_color = static_cast<Color>((state.color_at_play_ + 1) % 2);
+
+  const Bitboard& all_friendly = state.Occupancy(friendly_color);
+  const Bitboard& all_enemy = state.Occupancy(enemy_color);
+
+  // Remove piece from old position, place at new position.
+  Bitboard new_all_friendly = (all_friendly & (~before)) | after;
+  Bitboard new_all_enemy = (all_enemy & (~after));
+  if (is_en_passant) {
+    new_all_enemy &= ~state.en_passant_squares_;
+  }
+
+  // Determine king position.
+  Bitboard king_piece =
+      piece == kKing ? after : state.Pieces(friendly_color, kKing);
+  if (is_castling) {
+    king_piece = KingLocationAfterCastling(after);
+  }
+
+  // Check if this move leaves our king attacked. A captured piece is
+  // already gone from new_all_enemy, so it no longer attacks.
+  if (king_piece != kZeroBitboard &&
+      MoveEngine::IsSquareAttacked(king_piece.Lsb(), enemy_color, state.pieces_,
+                                   new_all_enemy,
+                                   new_all_friendly | new_all_enemy)) {
+    return;
+  }
+
+  AddActions(state, piece, before, after, is_en_passant, is_castling, moves);
+}
+
+void ChessAI::AddActions(const State& state, Piece piece,
+                         const Bitboard& before, const Bitboard& after,
+                         bool is_en_passant, bool is_castling,
+                         MoveList& moves) {
   const Bitboard kZeroBitboard(0);
   const Bitboard kFirstEighthRank(0xff000000000000ff);
   const Bitboard kSecondSeventhRank(0xff00000000ff00);
@@ -414,175 +1024,56 @@ std::vector<Action> ChessAI::Actions(const State& state) {
   const Bitboard kKingSideCastlingBefore(0x8000000000000080);
   const Bitboard kKingSideCastlingAfter(0x2000000000000020);
 
-  std::vector<Action> actions;
-
   Color friendly_color = state.color_at_play_;
-  Color enemy_color = static_cast<Color>((state.color_at_play_ + 1) % 2);
-
-  const std::vector<Bitboard>& friendly =
-      friendly_color == kWhite ? state.whites_ : state.blacks_;
-  const std::vector<Bitboard>& enemy =
-      enemy_color == kWhite ? state.whites_ : state.blacks_;
-
-  const Bitboard& all_friendly =
-      friendly_color == kWhite ? state.all_whites_ : state.all_blacks_;
   const Bitboard& all_enemy =
-      enemy_color == kWhite ? state.all_whites_ : state.all_blacks_;
-
-  const Bitboard& en_passant_squares = state.en_passant_squares_;
-  const Bitboard& castling_squares = state.castling_squares_;
-
-  // Move generators: piece type, is castling, is en passant, move function.
-  const std::vector<
-      std::tuple<Piece, bool, bool, std::function<Bitboard(Bitboard)>>>
-      move_generators = {
-          std::make_tuple(
-              kKing, false, false,
-              [&](const Bitboard& king_board) {
-                return MoveEngine::KingMoves(king_board, all_friendly);
-              }),
-          std::make_tuple(
-              kKnight, false, false,
-              [&](const Bitboard& knight_board) {
-                return MoveEngine::KnightMoves(knight_board, all_friendly);
-              }),
-          std::make_tuple(
-              kRook, false, false,
-              [&](const Bitboard& rook_board) {
-                return MoveEngine::RookMoves(rook_board, all_friendly,
-                                             all_enemy);
-              }),
-          std::make_tuple(
-              kBishop, false, false,
-              [&](const Bitboard& bishop_board) {
-                return MoveEngine::BishopMoves(bishop_board, all_friendly,
-                                               all_enemy);
-              }),
-          std::make_tuple(
-              kQueen, false, false,
-              [&](const Bitboard& queen_board) {
-                return MoveEngine::QueenMoves(queen_board, all_friendly,
-                                              all_enemy);
-              }),
-          std::make_tuple(
-              kPawn, false, false,
-              [&](const Bitboard& pawn_board) {
-                return MoveEngine::PawnMoves(pawn_board, all_friendly, all_enemy,
-                                             friendly_color);
-              }),
-          std::make_tuple(
-              kPawn, false, true,
-              [&](const Bitboard& pawn_board) {
-                return EnpassantMoveGenerator(pawn_board, en_passant_squares,
-                                              friendly_color);
-              }),
-          std::make_tuple(kRook, true, false, [&](const Bitboard& rook_board) {
-            return CastlingMoveGenerator(all_friendly, all_enemy,
-                                         castling_squares, rook_board);
-          })};
-
-  const std::initializer_list<Piece> promotable_pieces = {kQueen, kRook,
-                                                          kBishop, kKnight};
-
-  for (const auto& piece_and_attack : move_generators) {
-    Piece piece = std::get<0>(piece_and_attack);
-    bool is_castling = std::get<1>(piece_and_attack);
-    bool is_en_passant = std::get<2>(piece_and_attack);
-    auto move_generator = std::get<3>(piece_and_attack);
-
-    Bitboard current_board = friendly[MoveEngine::PieceToInt(piece)];
-
-    for (const Bitboard& piece_inside_board : current_board.Separated()) {
-      if (move_generator(piece_inside_board) == kZeroBitboard) {
-        continue;
-      }
+      state.Occupancy(static_cast<Color>((friendly_color + 1) % 2));
 
-      std::vector<Bitboard> locations =
-          move_generator(piece_inside_board).Separated();
-
-      for (const Bitboard& new_location : locations) {
-        // Remove piece from old position, place at new position.
-        Bitboard new_all_friendly =
-            (all_friendly & (~current_board)) | new_location;
-        Bitboard new_all_enemy = (all_enemy & (~new_location));
-
-        // Handle capture: update enemy bitboards.
-        std::vector<Bitboard> temp_all_enemy = enemy;
-        for (Bitboard& pieces : temp_all_enemy) {
-          pieces &= new_all_enemy;
-        }
-
-        // Check all enemy moves after this move.
-        Bitboard all_enemy_moves = MoveEngine::AllStandardMovesInOneBitboard(
-            temp_all_enemy, new_all_enemy, new_all_friendly, enemy_color);
-
-        // Determine king position.
-        Bitboard king_piece =
-            piece == kKing ? new_location : friendly[MoveEngine::PieceToInt(kKing)];
-        if (is_castling) {
-          king_piece = KingLocationAfterCastling(new_location);
-        }
-
-        // Check if this move leads to a pinned king.
-        Bitboard enemies_attacking_king = all_enemy_moves & king_piece;
-
-        if (enemies_attacking_king == kZeroBitboard) {
-          bool was_a_capture = WasCapture(all_enemy, new_location);
-          Piece captured_piece = FindCapturePiece(enemy, all_enemy, new_location);
-
-          Bitboard before = piece_inside_board;
-          Bitboard after = new_location;
-
-          bool double_pawn_forward =
-              (piece == kPawn) && ((before & kSecondSeventhRank) != kZeroBitboard) &&
-              ((after & kFourthFifthRank) != kZeroBitboard);
-          bool queen_side_castling =
-              is_castling
-                  ? ((before & kQueenSideCastlingBefore) != kZeroBitboard) &&
+  bool was_a_capture = WasCapture(all_enemy, after);
+  Piece captured_piece = FindCapturePiece(state.pieces_, all_enemy, after);
+
+  bool double_pawn_forward = (piece == kPawn) &&
+                             ((before & kSecondSeventhRank) != kZeroBitboard) &&
+                             ((after & kFourthFifthRank) != kZeroBitboard);
+  bool queen_side_castling =
+      is_castling ? ((before & kQueenSideCastlingBefore) != kZeroBitboard) &&
                         ((after & kQueenSideCastlingAfter) != kZeroBitboard)
                   : false;
-          bool king_side_castling =
-              is_castling
-                  ? ((before & kKingSideCastlingBefore) != kZeroBitboard) &&
+  bool king_side_castling =
+      is_castling ? ((before & kKingSideCastlingBefore) != kZeroBitboard) &&
                         ((after & kKingSideCastlingAfter) != kZeroBitboard)
                   : false;
 
-          bool enemy_in_check = false;
-
-          // Handle pawn promotions.
-          if ((piece == kPawn) &&
-              ((new_location & kFirstEighthRank) != kZeroBitboard)) {
-            bool was_promotion = true;
-
-            for (Piece promoted_piece : promotable_pieces) {
-              Action action(piece, friendly_color, before, after,
-                            double_pawn_forward, queen_side_castling,
-                            king_side_castling, enemy_in_check, was_a_capture,
-                            is_en_passant, captured_piece, was_promotion,
-                            promoted_piece);
-              actions.push_back(action);
-            }
-          } else {
-            bool was_promotion = false;
-            Piece promoted_to = kKing;
-
-            Action action(piece, friendly_color, before, after,
-                          double_pawn_forward, queen_side_castling,
-                          king_side_castling, enemy_in_check, was_a_capture,
-                          is_en_passant, captured_piece, was_promotion,
-                          promoted_to);
-            actions.push_back(action);
-          }
-        }
-      }
+  bool enemy_in_check = false;
+
+  // Handle pawn promotions.
+  if ((piece == kPawn) && ((after & kFirstEighthRank) != kZeroBitboard)) {
+    bool was_promotion = true;
+
+    for (Piece promoted_piece : {kQueen, kRook, kBishop, kKnight}) {
+      moves.Add(Action(piece, friendly_color, before, after,
+                       double_pawn_forward, queen_side_castling,
+                       king_side_castling, enemy_in_check, was_a_capture,
+                       is_en_passant, captured_piece, was_promotion,
+                       promoted_piece));
     }
-  }
+  } else {
+    bool was_promotion = false;
+    Piece promoted_to = kKing;
 
-  std::sort(actions.begin(), actions.end());
-  return actions;
+    moves.Add(Action(piece, friendly_color, before, after, double_pawn_forward,
+                     queen_side_castling, king_side_castling, enemy_in_check,
+                     was_a_capture, is_en_passant, captured_piece,
+                     was_promotion, promoted_to));
+  }
 }
 
 State ChessAI::Result(const State& state, const Action& action) {
+  State result = state;
+  MakeMove(result, action);
+  return result;
+}
+
+Undo ChessAI::MakeMove(State& state, const Action& action) {
   const Bitboard kZeroBitboard(0);
   const Bitboard kFourthFifthRank(0xffff000000);
   const Bitboard kSecondSeventhRank(0xff00000000ff00);
@@ -590,150 +1081,199 @@ State ChessAI::Result(const State& state, const Action& action) {
   Piece piece = action.GetPiece();
   Bitboard piece_before = action.PieceBefore();
   Bitboard piece_after = action.PieceAfter();
+  Piece moved_as = action.WasPromotion() ? action.PromotedTo() : piece;
 
-  bool was_capture = action.WasCapture();
-  Piece captured_piece = action.PieceCaptured();
-
-  bool was_promotion = action.WasPromotion();
-  Piece promoted_to = action.PromotedTo();
-
-  Color old_color_at_play = state.color_at_play_;
-  Color new_color_at_play =
-      static_cast<Color>((state.color_at_play_ + 1) % 2);
-
-  std::vector<Bitboard> whites = state.whites_;
-  std::vector<Bitboard> blacks = state.blacks_;
-
-  bool was_en_passant = action.WasEnPassantCapture();
-  bool was_castling =
-      action.QueenSideCastling() || action.KingSideCastling();
-
-  Bitboard en_passant_squares = kZeroBitboard;
-  Bitboard castling_squares = state.castling_squares_;
-
-  if (was_promotion) {
-    if (old_color_at_play == kWhite) {
-      whites[MoveEngine::PieceToInt(kPawn)] &= ~piece_before;
-      whites[MoveEngine::PieceToInt(promoted_to)] |= piece_after;
-
-      if (was_capture) {
-        blacks[MoveEngine::PieceToInt(captured_piece)] &= ~piece_after;
-      }
-    } else {
-      blacks[MoveEngine::PieceToInt(kPawn)] &= ~piece_before;
-      blacks[MoveEngine::PieceToInt(promoted_to)] |= piece_after;
-
-      if (was_capture) {
-        whites[MoveEngine::PieceToInt(captured_piece)] &= ~piece_after;
-      }
-    }
-  } else if (old_color_at_play == kWhite) {
-    whites[MoveEngine::PieceToInt(piece)] &= ~piece_before;
-    whites[MoveEngine::PieceToInt(piece)] |= piece_after;
+  Color friendly_color = state.color_at_play_;
+  Color enemy_color = static_cast<Color>((friendly_color + 1) % 2);
 
-    if (was_capture) {
-      blacks[MoveEngine::PieceToInt(captured_piece)] &= ~piece_after;
+  Undo undo{state.en_passant_squares_, state.castling_squares_,
+            kZeroBitboard, state.key_, state.pawn_key_, state.psqt_,
+            state.phase_};
+  PieceBoards& pieces = state.pieces_;
+  uint64_t& key = state.key_;
+  uint64_t& pawn_key = state.pawn_key_;
+  Score& psqt = state.psqt_;
+
+  Bitboard& friendly =
+      state.color_at_play_ == kWhite ? state.all_whites_ : state.all_blacks_;
+  Bitboard& enemy =
+      state.color_at_play_ == kWhite ? state.all_blacks_ : state.all_whites_;
+
+  if (action.WasCapture()) {
+    pieces[MoveEngine::PieceToInt(action.PieceCaptured())] &= ~piece_after;
+    enemy &= ~piece_after;
+    key ^= Zobrist::PieceKeys(enemy_color, action.PieceCaptured(), piece_after);
+    psqt -= PieceSquare::Value(enemy_color, action.PieceCaptured(),
+                               piece_after.Lsb());
+    state.phase_ -= kPhaseWeights[MoveEngine::PieceToInt(
+        action.PieceCaptured())];
+    if (action.PieceCaptured() == kPawn) {
+      pawn_key ^= Zobrist::PieceKeys(enemy_color, kPawn, piece_after);
     }
+  }
 
-    if (was_en_passant) {
-      blacks[MoveEngine::PieceToInt(kPawn)] &= ~state.en_passant_squares_;
-    }
+  if (action.WasEnPassantCapture()) {
+    pieces[MoveEngine::PieceToInt(kPawn)] &= ~state.en_passant_squares_;
+    enemy &= ~state.en_passant_squares_;
+    key ^= Zobrist::PieceKeys(enemy_color, kPawn, state.en_passant_squares_);
+    psqt -= PieceSquare::Values(enemy_color, kPawn, state.en_passant_squares_);
+    pawn_key ^=
+        Zobrist::PieceKeys(enemy_color, kPawn, state.en_passant_squares_);
+  }
 
-    if (was_castling) {
-      whites[MoveEngine::PieceToInt(kKing)] =
-          KingLocationAfterCastling(piece_after);
-    }
+  if (action.QueenSideCastling() || action.KingSideCastling()) {
+    Bitboard& kings = pieces[MoveEngine::PieceToInt(kKing)];
+    Bitboard king_after = KingLocationAfterCastling(piece_after);
+
+    undo.king_before_castling = kings & friendly;
+    kings = (kings & ~undo.king_before_castling) | king_after;
+    friendly = (friendly & ~undo.king_before_castling) | king_after;
+    key ^= Zobrist::PieceKeys(friendly_color, kKing,
+                              undo.king_before_castling ^ king_after);
+    psqt += PieceSquare::Values(friendly_color, kKing, king_after) -
+            PieceSquare::Values(friendly_color, kKing,
+                                undo.king_before_castling);
+  }
 
-  } else {
-    blacks[MoveEngine::PieceToInt(piece)] &= ~piece_before;
-    blacks[MoveEngine::PieceToInt(piece)] |= piece_after;
+  pieces[MoveEngine::PieceToInt(piece)] &= ~piece_before;
+  pieces[MoveEngine::PieceToInt(moved_as)] |= piece_after;
+  friendly = (friendly & ~piece_before) | piece_after;
+  key ^= Zobrist::PieceKeys(friendly_color, piece, piece_before) ^
+         Zobrist::PieceKeys(friendly_color, moved_as, piece_after);
+  psqt += PieceSquare::Value(friendly_color, moved_as, piece_after.Lsb()) -
+          PieceSquare::Value(friendly_color, piece, piece_before.Lsb());
+  state.phase_ += kPhaseWeights[MoveEngine::PieceToInt(moved_as)] -
+                  kPhaseWeights[MoveEngine::PieceToInt(piece)];
+  if (piece == kPawn) {
+    pawn_key ^= Zobrist::PieceKeys(friendly_color, kPawn, piece_before);
+  }
+  if (moved_as == kPawn) {
+    pawn_key ^= Zobrist::PieceKeys(friendly_color, kPawn, piece_after);
+  }
 
-    if (was_capture) {
-      whites[MoveEngine::PieceToInt(captured_piece)] &= ~piece_after;
-    }
+  key ^= Zobrist::EnPassantKeys(state.en_passant_squares_) ^
+         Zobrist::CastlingKeys(state.castling_squares_) ^ Zobrist::SideKey();
 
-    if (was_en_passant) {
-      whites[MoveEngine::PieceToInt(kPawn)] &= ~state.en_passant_squares_;
-    }
+  state.en_passant_squares_ = kZeroBitboard;
+  state.color_at_play_ = enemy_color;
 
-    if (was_castling) {
-      whites[MoveEngine::PieceToInt(kKing)] =
-          KingLocationAfterCastling(piece_after);
-    }
+  // Moving the king gives up both castles. A rook leaving its home square,
+  // or being captured there, gives up that side. Castling is encoded as a
+  // rook move, so it counts as both.
+  const Bitboard kHomeRookSquares(0x81);
+  if (piece == kKing || action.QueenSideCastling() ||
+      action.KingSideCastling()) {
+    state.castling_squares_ &=
+        ~(friendly_color == kWhite ? kHomeRookSquares : kHomeRookSquares << 56);
   }
+  state.castling_squares_ &= ~(piece_before | piece_after);
 
-  // If rook moved, disable castling from that side.
-  if (piece == kRook) {
-    castling_squares &= ~piece_before;
-  } else if (piece == kPawn) {
+  if (piece == kPawn) {
     // If pawn moved two squares, set en passant square.
     if ((piece_before & kSecondSeventhRank) != kZeroBitboard &&
         (piece_after & kFourthFifthRank) != kZeroBitboard) {
-      en_passant_squares |= piece_after;
+      state.en_passant_squares_ |= piece_after;
     }
   }
 
-  Bitboard all_whites = MoveEngine::AllBitboardsInOneBoard(whites);
-  Bitboard all_blacks = MoveEngine::AllBitboardsInOneBoard(blacks);
+  key ^= Zobrist::EnPassantKeys(state.en_passant_squares_) ^
+         Zobrist::CastlingKeys(state.castling_squares_);
 
-  return State(new_color_at_play, all_whites, all_blacks, whites, blacks,
-               en_passant_squares, castling_squares);
+  return undo;
 }
 
-ChessOutcome ChessAI::TerminalTest(const State& state,
-                                   const PerceptSequence& history) {
-  const Bitboard kZeroBitboard(0);
+void ChessAI::UnmakeMove(State& state, const Action& action,
+                         const Undo& undo) {
+  Piece piece = action.GetPiece();
+  Bitboard piece_before = action.PieceBefore();
+  Bitboard piece_after = action.PieceAfter();
 
-  Color friendly_color = state.color_at_play_;
-  Color enemy_color = static_cast<Color>((friendly_color + 1) % 2);
+  Piece moved_as = action.WasPromotion() ? action.PromotedTo() : piece;
 
-  const std::vector<Bitboard>& friendly =
-      friendly_color == kWhite ? state.whites_ : state.blacks_;
-  const std::vector<Bitboard>& enemy =
-      enemy_color == kWhite ? state.whites_ : state.blacks_;
+  state.color_at_play_ = static_cast<Color>((state.color_at_play_ + 1) % 2);
+  state.en_passant_squares_ = undo.en_passant_squares;
+  state.castling_squares_ = undo.castling_squares;
+  state.key_ = undo.key;
+  state.pawn_key_ = undo.pawn_key;
+  state.psqt_ = undo.psqt;
+  state.phase_ = undo.phase;
 
-  const Bitboard& all_friendly =
-      friendly_color == kWhite ? state.all_whites_ : state.all_blacks_;
-  const Bitboard& all_enemy =
-      enemy_color == kWhite ? state.all_whites_ : state.all_blacks_;
+  PieceBoards& pieces = state.pieces_;
 
-  State friendly_state = state;
+  Bitboard& friendly =
+      state.color_at_play_ == kWhite ? state.all_whites_ : state.all_blacks_;
+  Bitboard& enemy =
+      state.color_at_play_ == kWhite ? state.all_blacks_ : state.all_whites_;
 
-  Bitboard all_enemy_moves = MoveEngine::AllStandardMovesInOneBitboard(
-      enemy, all_enemy, all_friendly, enemy_color);
+  // Lift the mover before restoring a capture on the same square.
+  pieces[MoveEngine::PieceToInt(moved_as)] &= ~piece_after;
+  pieces[MoveEngine::PieceToInt(piece)] |= piece_before;
+  friendly = (friendly & ~piece_after) | piece_before;
 
-  if (Actions(friendly_state).empty()) {
-    if ((friendly[MoveEngine::PieceToInt(kKing)] & all_enemy_moves) ==
-        kZeroBitboard) {
-      return kDraw;
-    } else {
-      return kLoss;
-    }
-  } else if (IsEightfoldRepetitionRule(history)) {
-    return kDraw;
-  } else if (InsufficientMaterial(friendly_state)) {
-    return kDraw;
-  } else if (FiftyMoveRule(history)) {
+  if (action.QueenSideCastling() || action.KingSideCastling()) {
+    Bitboard& kings = pieces[MoveEngine::PieceToInt(kKing)];
+    Bitboard king_after = KingLocationAfterCastling(piece_after);
+
+    kings = (kings & ~king_after) | undo.king_before_castling;
+    friendly = (friendly & ~king_after) | undo.king_before_castling;
+  }
+
+  if (action.WasEnPassantCapture()) {
+    pieces[MoveEngine::PieceToInt(kPawn)] |= undo.en_passant_squares;
+    enemy |= undo.en_passant_squares;
+  }
+
+  if (action.WasCapture()) {
+    pieces[MoveEngine::PieceToInt(action.PieceCaptured())] |= piece_after;
+    enemy |= piece_after;
+  }
+}
+
+ChessOutcome ChessAI::TerminalTest(const State& state,
+                                   const PerceptSequence& history) {
+  if (!HasLegalAction(state)) {
+    return InCheck(state) ? kLoss : kDraw;
+  } else if (IsDrawn(state, history)) {
     return kDraw;
   }
 
   return kNonterminal;
 }
 
+bool ChessAI::IsDrawn(const State& state, const PerceptSequence& history) {
+  return history.IsRepetition() || InsufficientMaterial(state) ||
+         FiftyMoveRule(history);
+}
+
+bool ChessAI::HasLegalAction(const State& state) {
+  MoveList moves;
+  GenerateActions(state, kAllMoves, moves);
+  return !moves.Empty();
+}
+
 float ChessAI::UtilityFunction(const State& state, Color friendly_color,
                                const PerceptSequence& history) {
-  ChessOutcome terminal_result = TerminalTest(state, history);
+  return OutcomeUtility(TerminalTest(state, history), state, friendly_color);
+}
+
+float ChessAI::NoActionUtility(const State& state, Color friendly_color) {
+  return OutcomeUtility(InCheck(state) ? kLoss : kDraw, state,
+                        friendly_color);
+}
+
+float ChessAI::OutcomeUtility(ChessOutcome terminal_result, const State& state,
+                              Color friendly_color) {
   ChessOutcome outcome;
 
   if (state.color_at_play_ == friendly_color) {
     outcome = terminal_result;
   } else {
-    if (terminal_result == kNonterminal) {
-      outcome = terminal_result;
-    } else if (terminal_result == kWin) {
+    if (terminal_result == kWin) {
       outcome = kLoss;
-    } else {
+    } else if (terminal_result == kLoss) {
       outcome = kWin;
+    } else {
+      outcome = terminal_result;
     }
   }
 
@@ -749,67 +1289,223 @@ float ChessAI::UtilityFunction(const State& state, Color friendly_color,
   return worst_mode_ ? -result : result;
 }
 
-float ChessAI::UtilityHeuristic(const State& state, Color player_color) {
-  float score = ChessAIHeuristic<float>::MaterialAdvantage(state, player_color);
+bool ChessAI::TablebaseUtility(const State& state, Color friendly_color,
+                               int ply, float& value) {
+  // Below a mate, which is infinite, and above any evaluation. Nearer wins
+  // score higher so that the search heads for them. The transposition table
+  // keeps scores as int16 centipawns, so every such score must fit in one.
+  const float kTablebaseWin = 300;
+
+  ChessOutcome outcome;
+  if (worst_mode_ || !Tablebases::ProbeWdl(state, outcome)) {
+    return false;
+  }
+
+  value = outcome == kDraw ? 0 : kTablebaseWin - ply;
+  if (outcome == kLoss) {
+    value = -value;
+  }
+  if (state.color_at_play_ != friendly_color) {
+    value = -value;
+  }
+  return true;
+}
+
+float ChessAI::UtilityHeuristic(const State& state, Color player_color,
+                                SearchThread& thread) {
+  StatsTimer timer(thread.stats.evaluation_time);
+
+  float score;
+  if (network_.Loaded()) {
+    int centipawns = network_.Evaluate(thread.accumulators.Current(network_),
+                                       state.color_at_play_);
+    if (player_color != state.color_at_play_) {
+      centipawns = -centipawns;
+    }
+    score = static_cast<float>(centipawns) / 100;
+  } else {
+    score = ChessAIHeuristic<float>::Evaluate(state, player_color,
+                                              &thread.pawn_table);
+  }
   // In worst mode, negate the score to make AI pick the worst moves.
   return worst_mode_ ? -score : score;
 }
 
-void ChessAI::UpdateTimer(double time_remaining_seconds) {
+void ChessAI::UpdateTimer(double time_remaining_seconds,
+                          double increment_seconds, int moves_to_go) {
   time_remaining_ = time_remaining_seconds;
+  increment_ = increment_seconds;
+  moves_to_go_ = moves_to_go;
 }
 
 Action ChessAI::Move() {
+  ClearStop();
   move_timer_.Start();
 
-  double time_limit = time_calculator_(half_move_number_, time_remaining_);
-  Action move = Minimax(time_limit, current_state_, history_);
+  Action move;
+  if (!BookMove(move)) {
+    move = SearchOnClock();
+  }
 
-  current_state_ = Result(current_state_, move);
-  history_.Add(current_state_);
-  history_.Add(move);
+  MakeMove(current_state_, move);
+  history_.Add(current_state_, move);
 
   half_move_number_ += 1;
-  time_remaining_ -= move_timer_.Elapsed();
+  time_remaining_ += increment_ - move_timer_.Elapsed();
+  if (moves_to_go_ > 0) {
+    moves_to_go_--;
+  }
 
   move_timer_.Stop();
 
   return move;
 }
 
+Action ChessAI::Search(double time_limit, int max_depth) {
+  move_timer_.Start();
+  time_calculator_.PlanFixed(time_limit);
+  return Minimax(time_limit, current_state_, history_, max_depth);
+}
+
+Action ChessAI::SearchOnClock(int max_depth) {
+  move_timer_.Start();
+  time_calculator_.Plan(half_move_number_, time_remaining_, increment_,
+                        moves_to_go_);
+
+  // With a single reply there is nothing to think about.
+  if (Actions(current_state_).size() == 1) {
+    max_depth = 1;
+  }
+
+  return Minimax(time_calculator_.HardLimit(), current_state_, history_,
+                 max_depth);
+}
+
+bool ChessAI::BookMove(Action& action) {
+  return !worst_mode_ && book_.Probe(current_state_, action);
+}
+
 void ChessAI::UpdateMove(const Action& action) {
-  current_state_ = Result(current_state_, action);
+  MakeMove(current_state_, action);
 
-  history_.Add(current_state_);
-  history_.Add(action);
+  history_.Add(current_state_, action);
 
   half_move_number_ += 1;
 }
 
 Action ChessAI::Minimax(double time_limit, const State& state,
-                        const PerceptSequence& history) {
-  static Timer local_timer;
+                        const PerceptSequence& history, int max_depth) {
+  // The per-ply buffers of each thread go no deeper.
+  max_depth = std::min(max_depth, kMaxSearchDepth);
 
-  int depth_limit = 1;
-  int quiescence_limit = 4;
+  completed_depth_ = 0;
+  completed_move_ = Actions(state)[0];
+  completed_value_ = 0;
+  searched_nodes_ = 0;
+  searched_stats_ = SearchStats();
 
-  Action last_move = Actions(state)[0];
-  std::map<Action, int> history_table;
+  // A solved position needs no search.
+  ChessOutcome outcome;
+  if (!worst_mode_ && Tablebases::ProbeRoot(state, history.HalfmoveClock(),
+                                            completed_move_, outcome)) {
+    TablebaseUtility(state, state.color_at_play_, 0, completed_value_);
+    return completed_move_;
+  }
+  table_->NewSearch();
 
-  std::shared_ptr<Action> move;
+  // Thread state is made once and kept for every later search.
+  while (static_cast<int>(search_threads_.size()) < threads_) {
+    search_threads_.emplace_back(new SearchThread());
+  }
+
+  // Helpers start on alternating depths so they are rarely on the same
+  // iteration as the main thread, and fill the table ahead of it.
+  std::vector<std::thread> helpers;
+  for (int i = 1; i < threads_; i++) {
+    SearchThread& thread = *search_threads_[i];
+    helpers.emplace_back(
+        [this, i, max_depth, time_limit, &state, &history, &thread]() {
+          IterativeDeepening(1 + i % 2, max_depth, time_limit, state, history,
+                             thread, false);
+        });
+  }
+
+  IterativeDeepening(1, max_depth, time_limit, state, history,
+                     *search_threads_[0], true);
+
+  // Release the helpers. The flag stays raised until the next ClearStop.
+  stop_ = true;
+  for (std::thread& helper : helpers) {
+    helper.join();
+  }
+
+  return completed_move_;
+}
+
+void ChessAI::IterativeDeepening(int depth_limit, int max_depth,
+                                 double time_limit, const State& state,
+                                 const PerceptSequence& history,
+                                 SearchThread& thread, bool is_main_thread) {
+  // Everything but the pawn table, which only ever holds exact entries,
+  // starts over.
+  thread.move_history.Clear();
+  thread.history = history;
+  thread.accumulators.Reset(network_, state);
+  thread.nodes = 0;
+  thread.next_clock_check = 0;
+  thread.stats = SearchStats();
+  Timer iteration_timer;
+
+  Action move(0);
+  float value = 0;
+
+  while (depth_limit <= max_depth && !stop_.load(std::memory_order_relaxed)) {
+    iteration_timer.Start();
+    bool completed;
+    if (search_algorithm_ == kPrincipalVariationSearch) {
+      completed =
+          AspirationSearch(depth_limit, kQuiescenceLimit, time_limit, state,
+                           value, thread, move, value);
+    } else {
+      completed = DepthLimitedMinimax(depth_limit, kQuiescenceLimit,
+                                      time_limit, state, thread, move, value);
+    }
+    iteration_timer.Stop();
 
-  do {
-    local_timer.Start();
-    move = DepthLimitedMinimax(depth_limit++, quiescence_limit, time_limit,
-                               state, history_table, history);
-    local_timer.Stop();
+    if (!completed) {
+      break;
+    }
+    if (kSearchStats && is_main_thread && stats_output_) {
+      stats_output_(thread.stats.ToInfo(depth_limit, iteration_timer.Elapsed(),
+                                        thread.nodes));
+    }
+    ReportCompletedDepth(depth_limit++, move, value);
 
-    if (move != nullptr) {
-      last_move = *move;
+    if (is_main_thread) {
+      time_calculator_.CompleteIteration(move, value,
+                                         iteration_timer.Elapsed());
+      if (!time_calculator_.StartIteration(move_timer_.Elapsed())) {
+        break;
+      }
     }
-  } while (move_timer_.Elapsed() + local_timer.Elapsed() < time_limit);
+  }
 
-  return last_move;
+  searched_nodes_ += thread.nodes;
+  if (kSearchStats) {
+    std::lock_guard<std::mutex> lock(completed_mutex_);
+    searched_stats_ += thread.stats;
+  }
+}
+
+void ChessAI::ReportCompletedDepth(int depth, const Action& action,
+                                   float value) {
+  std::lock_guard<std::mutex> lock(completed_mutex_);
+
+  if (depth > completed_depth_) {
+    completed_depth_ = depth;
+    completed_move_ = action;
+    completed_value_ = value;
+  }
 }
 
 }  // namespace ChessEngine
@@ -10,13 +10,17 @@
 #define CHESS_AI_CHESS_AI_H_
 
 #include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <functional>
 #include <limits>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <numeric>
 #include <random>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <utility>
 #include <vector>
@@ -29,12 +33,23 @@
 #include "chess-outcome.h"
 #include "color.h"
 #include "fen-parser.h"
+#include "move-list.h"
+#include "move-ordering.h"
 #include "move-time-calculator.h"
+#include "nnue.h"
+#include "polyglot-book.h"
+#include "search-thread.h"
 #include "state.h"
+#include "tablebases.h"
 #include "timer.h"
+#include "transposition-table.h"
+#include "zobrist.h"
 
 namespace ChessEngine {
 
+// Minimax is the original alpha-beta search, kept to compare against.
+enum SearchAlgorithm { kMinimaxSearch, kPrincipalVariationSearch };
+
 class ChessAI {
  public:
   // Static flag for "worst moves" mode - inverts the evaluation function
@@ -42,6 +57,46 @@ class ChessAI {
   static bool worst_mode_;
   static void SetWorstMode(bool enabled) { worst_mode_ = enabled; }
 
+  // Search used by every ChessAI in the process.
+  static SearchAlgorithm search_algorithm_;
+  static void SetSearchAlgorithm(SearchAlgorithm algorithm) {
+    search_algorithm_ = algorithm;
+  }
+
+  // Search results shared by every search in the process, unless a ChessAI
+  // is given a table of its own with UseTable.
+  static TranspositionTable transposition_table_;
+  static void SetHashSize(size_t megabytes) {
+    transposition_table_.Resize(megabytes);
+  }
+
+  // Number of threads searching each move. Helpers share the transposition
+  // table with the main thread (Lazy SMP).
+  static int threads_;
+  static void SetThreads(int threads) { threads_ = std::max(threads, 1); }
+
+  // Nodes each search thread visits between reads of the clock. Reading
+  // it is slow next to a node, and the time limit only needs to be met to
+  // within a few milliseconds.
+  static int clock_check_interval_;
+  static void SetClockCheckInterval(int nodes) {
+    clock_check_interval_ = std::max(nodes, 1);
+  }
+
+  // Replaces the handcrafted evaluation once loaded, for every search in
+  // the process.
+  static NnueNetwork network_;
+  static bool LoadNetwork(const std::string& path, std::string& error) {
+    return network_.Load(path, error);
+  }
+
+  // Consulted before every search from a position it knows, unless in
+  // worst mode.
+  static PolyglotBook book_;
+  static bool OpenBook(const std::string& path, std::string& error) {
+    return book_.Open(path, error);
+  }
+
   // Public members are initialized first to avoid warnings about
   // initialization order. Parser must come before current_state_ since
   // current_state_ uses parser_ during initialization.
@@ -60,21 +115,74 @@ class ChessAI {
   // AI operations
   static State InitialState();
   static std::vector<Action> Actions(const State& state);
+  // Appends the legal actions of one stage to moves, without allocating.
+  static void GenerateActions(const State& state, MoveStage stage,
+                              MoveList& moves);
   static State Result(const State& state, const Action& action);
 
+  // Apply or take back an action in place. Only the boards the action touches
+  // are updated; UnmakeMove needs the Undo returned by the matching MakeMove.
+  static Undo MakeMove(State& state, const Action& action);
+  static void UnmakeMove(State& state, const Action& action, const Undo& undo);
+
   static ChessOutcome TerminalTest(const State& state,
                                    const PerceptSequence& history);
   static float UtilityFunction(const State& state, Color friendly_color,
                                const PerceptSequence& history);
-  static float UtilityHeuristic(const State& state, Color friendly_color);
+  // The utility for friendly_color of an outcome for the side to move.
+  static float OutcomeUtility(ChessOutcome terminal_result, const State& state,
+                              Color friendly_color);
+  // The network's score if one is loaded, and the handcrafted evaluation,
+  // through the thread's pawn hash table, otherwise.
+  static float UtilityHeuristic(const State& state, Color friendly_color,
+                                SearchThread& thread);
 
-  void UpdateTimer(double time_remaining_seconds);
+  // Centipawns the side making the action wins (or loses, if negative) on
+  // its target square once both sides have recaptured there, least
+  // valuable attacker first, for as long as it pays.
+  static int StaticExchange(const State& state, const Action& action);
+
+  // The clock for the side to move. moves_to_go is 0 in sudden death.
+  void UpdateTimer(double time_remaining_seconds,
+                   double increment_seconds = 0, int moves_to_go = 0);
   void UpdateMove(const Action& action);
 
   Action Minimax(double time_limit, const State& state,
-                 const PerceptSequence& history);
+                 const PerceptSequence& history,
+                 int max_depth = kMaxSearchDepth);
   Action Move();
 
+  // Searches the current position without playing the result. The time
+  // limit may be infinite, in which case only Stop or max_depth end it.
+  Action Search(double time_limit, int max_depth = kMaxSearchDepth);
+  // Like Search, but the time comes from the clock set by UpdateTimer, and
+  // how much of it is used depends on how the search goes.
+  Action SearchOnClock(int max_depth = kMaxSearchDepth);
+  // A move for the current position from the opening book, if one is open
+  // and knows the position. Nothing is searched.
+  bool BookMove(Action& action);
+  int CompletedDepth() const { return completed_depth_; }
+  // Score of the completed move for the side to move, in pawns, and the
+  // nodes every search thread visited.
+  float CompletedValue() const { return completed_value_; }
+  uint64_t SearchedNodes() const { return searched_nodes_; }
+  // Counts of every search thread, summed, with make STATS=1.
+  const SearchStats& SearchedStats() const { return searched_stats_; }
+  // Receives an info line after each iteration of the main thread, with
+  // make STATS=1.
+  void SetStatsOutput(std::function<void(const std::string&)> output) {
+    stats_output_ = std::move(output);
+  }
+
+  // Searches with table in place of the shared one, which it must outlive.
+  // Not safe while a search is running.
+  void UseTable(TranspositionTable& table) { table_ = &table; }
+
+  // Ends a running Search early, from any thread. A stop requested before
+  // a search starts ends it at once, so callers re-arm with ClearStop.
+  void Stop() { stop_ = true; }
+  void ClearStop() { stop_ = false; }
+
  private:
   MoveTimeCalculator time_calculator_;
 
@@ -82,54 +190,186 @@ class ChessAI {
   Timer move_timer_;
 
   double time_remaining_;  // in seconds
+  double increment_;       // in seconds
+  int moves_to_go_;
   int half_move_number_;
 
+  // Raised when the current search must end; every search thread polls it.
+  std::atomic<bool> stop_;
+
+  // Deepest iteration completed by any thread during the current search.
+  std::mutex completed_mutex_;
+  int completed_depth_;
+  Action completed_move_;
+  float completed_value_;
+  std::atomic<uint64_t> searched_nodes_;
+  TranspositionTable* table_;
+  SearchStats searched_stats_;
+  std::function<void(const std::string&)> stats_output_;
+
+  // One per search thread, the main thread first, reused by every search
+  // so their tables and per-ply buffers are allocated once.
+  std::vector<std::unique_ptr<SearchThread>> search_threads_;
+
   static bool WasCapture(const Bitboard& enemy_bitboard, const Bitboard& move);
-  static Piece FindCapturePiece(const std::vector<Bitboard>& enemy_bitboards,
+  static Piece FindCapturePiece(const PieceBoards& pieces,
                                 const Bitboard& enemy_bitboard,
                                 const Bitboard& move);
 
   static Bitboard EnpassantMoveGenerator(const Bitboard& en_passant_squares,
                                          const Bitboard& pawn,
                                          Color friendly_color);
-  static Bitboard CastlingMoveGenerator(const Bitboard& all_whites,
-                                        const Bitboard& all_blacks,
-                                        const Bitboard& castling_squares,
+  static Bitboard CastlingMoveGenerator(const State& state,
                                         const Bitboard& rook);
   static Bitboard KingLocationAfterCastling(const Bitboard& rook_after);
 
-  static bool IsEightfoldRepetitionRule(const PerceptSequence& from_history);
+  // Adds the action (all four promotions for a pawn reaching the last rank).
+  static void AddActions(const State& state, Piece piece,
+                         const Bitboard& before, const Bitboard& after,
+                         bool is_en_passant, bool is_castling,
+                         MoveList& moves);
+  // Like AddActions, but only if the action does not leave the mover's king
+  // attacked. Too slow for every move; GenerateActions needs it only for
+  // en passant.
+  static void AddIfLegal(const State& state, Piece piece,
+                         const Bitboard& before, const Bitboard& after,
+                         bool is_en_passant, bool is_castling,
+                         MoveList& moves);
+
+  // Draws that need no move generation: repetition, insufficient material
+  // and the fifty-move rule. The search finds mate and stalemate from its
+  // own move loop coming up empty.
+  static bool IsDrawn(const State& state, const PerceptSequence& history);
+  static bool HasLegalAction(const State& state);
+  // Checkmate or stalemate, for a state with no legal action.
+  static float NoActionUtility(const State& state, Color friendly_color);
+  // The tablebase result for friendly_color, ply moves from the root, if the
+  // state is in the tables.
+  static bool TablebaseUtility(const State& state, Color friendly_color,
+                               int ply, float& value);
   static bool InsufficientMaterial(const State& current_state);
   static bool FiftyMoveRule(const PerceptSequence& history);
 
-  std::shared_ptr<Action> DepthLimitedMinimax(
-      int depth_limit, int quiescence_limit, double time_limit,
-      const State& state, std::map<Action, int>& history_table,
-      const PerceptSequence& history);
-  std::shared_ptr<float> MaxValue(int depth_limit, int quiescence_limit,
-                                  double time_limit, const State& state,
-                                  const Action& action, float alpha, float beta,
-                                  Color color,
-                                  std::map<Action, int>& history_table,
-                                  const PerceptSequence& history);
-  std::shared_ptr<float> MinValue(int depth_limit, int quiescence_limit,
-                                  double time_limit, const State& state,
-                                  const Action& action, float alpha, float beta,
-                                  Color color,
-                                  std::map<Action, int>& history_table,
-                                  const PerceptSequence& history);
-
-  void AddToHistoryTable(std::map<Action, int>& history_table,
-                         const Action& action);
+  // Searches ever deeper from the given depth until stopped, in thread.
+  // The main thread also stops once time_calculator_ says another
+  // iteration is not worth starting.
+  void IterativeDeepening(int depth_limit, int max_depth, double time_limit,
+                          const State& state, const PerceptSequence& history,
+                          SearchThread& thread, bool is_main_thread);
+  void ReportCompletedDepth(int depth, const Action& action, float value);
+
+  // Whether the search must end, reading the clock only every
+  // clock_check_interval_ nodes. Running out of time raises stop_, so the
+  // other threads and every caller up the tree see the same answer.
+  bool ShouldStop(SearchThread& thread, double time_limit) {
+    if (stop_.load(std::memory_order_relaxed)) {
+      return true;
+    }
+    if (thread.nodes < thread.next_clock_check) {
+      return false;
+    }
+
+    thread.next_clock_check = thread.nodes + clock_check_interval_;
+    if (move_timer_.Elapsed() > time_limit) {
+      stop_ = true;
+      return true;
+    }
+    return false;
+  }
+
+  // Sets best_action to the highest scoring root action and best_value to
+  // its score. False if the search was stopped, leaving both as they were.
+  bool DepthLimitedMinimax(int depth_limit, int quiescence_limit,
+                           double time_limit, const State& state,
+                           SearchThread& thread, Action& best_action,
+                           float& best_value);
+  // Ply counts the moves made since the root, for the killer moves. As
+  // with PrincipalVariation, the result means nothing once ShouldStop is
+  // true.
+  float MaxValue(int depth_limit, int quiescence_limit, double time_limit,
+                 State& state, float alpha, float beta, Color color,
+                 SearchThread& thread, int ply);
+  float MinValue(int depth_limit, int quiescence_limit, double time_limit,
+                 State& state, float alpha, float beta, Color color,
+                 SearchThread& thread, int ply);
+
+  // Repeats PrincipalVariationRoot in ever wider windows around the
+  // previous iteration's score until the result falls inside one.
+  // best_action holds the previous best move on entry.
+  bool AspirationSearch(int depth_limit, int quiescence_limit,
+                        double time_limit, const State& state,
+                        float previous_value, SearchThread& thread,
+                        Action& best_action, float& best_value);
+  // Searches every root move inside the window, best_action first, and
+  // sets the best one. False if the search was stopped.
+  bool PrincipalVariationRoot(int depth_limit, int quiescence_limit,
+                              double time_limit, State& state, float alpha,
+                              float beta, SearchThread& thread,
+                              Action& best_action, float& best_value);
+  // Negamax alpha-beta scored for the side to move. Moves after the first
+  // are tried with a null window, late quiet ones also a little shallower,
+  // and searched again in full only when they beat alpha. Null-move
+  // pruning cuts nodes where even passing fails high. The result means
+  // nothing once ShouldStop is true.
+  float PrincipalVariation(int depth_limit, int quiescence_limit,
+                           double time_limit, State& state, float alpha,
+                           float beta, bool allow_null_move,
+                           SearchThread& thread, int ply);
+
+  // Passes the turn, for null-move pruning.
+  static Undo MakeNullMove(State& state);
+  static void UnmakeNullMove(State& state, const Undo& undo);
+
+  // Whether the side to move is in check.
+  static bool InCheck(const State& state);
+  // Whether the side to move has a piece besides its king and pawns.
+  static bool HasNonPawnMaterial(const State& state);
+
+  // The smallest score above alpha: searching (alpha, NullWindowAbove(alpha))
+  // only answers whether a move beats alpha.
+  static float NullWindowAbove(float alpha) {
+    return std::nextafter(alpha, std::numeric_limits<float>::infinity());
+  }
+
+  // Captures and promotions only, scored for the side to move. Standing
+  // pat on the static evaluation bounds every node, and captures that
+  // lose material by StaticExchange are skipped.
+  static float Quiescence(int quiescence_limit, State& state, float alpha,
+                          float beta, SearchThread& thread, int ply);
+
+  // The search's own steps, timed into thread.stats when stats are on.
+  static bool NextAction(MovePicker& picker, Action& action,
+                         SearchThread& thread) {
+    StatsTimer timer(thread.stats.generation_time);
+    return picker.Next(action);
+  }
+  static Undo MakeMove(State& state, const Action& action,
+                       SearchThread& thread) {
+    StatsTimer timer(thread.stats.make_move_time);
+    return MakeMove(state, action);
+  }
+  static void UnmakeMove(State& state, const Action& action, const Undo& undo,
+                         SearchThread& thread) {
+    StatsTimer timer(thread.stats.make_move_time);
+    UnmakeMove(state, action, undo);
+  }
+
+
+  // The table keeps scores for the side to move; the search keeps them for
+  // the root color, so these convert on the way in and out. A probe that
+  // finds the position sets table_move even when the score is unusable.
+  bool ProbeTransposition(const State& state, int depth, float alpha,
+                          float beta, Color color, SearchThread& thread,
+                          float& value, Action& table_move);
+  void StoreTransposition(const State& state, int depth, float value,
+                          float alpha, float beta, const Action& best_action,
+                          Color color);
 
   static State FlipColorAtPlay(State state) {
     state.color_at_play_ = static_cast<Color>((state.color_at_play_ + 1) % 2);
+    state.key_ ^= Zobrist::SideKey();
     return state;
   }
-
-  static bool IsNonQuiescenceState(const Action& action) {
-    return action.WasCapture() || action.WasPromotion() || action.EnemyInCheck();
-  }
 };
 
 }  // namespace ChessEngine
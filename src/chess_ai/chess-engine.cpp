@@ -152,36 +152,6 @@ Bitboard MoveEngine::SouthwestMovesWithBlockers(
   return result;
 }
 
-Bitboard MoveEngine::PawnNorthMovesWithBlockers(
-    Bitboard board, const Bitboard& blocker_inverse) {
-  Bitboard result = board;
-  result |= board = (board << 8) & blocker_inverse;
-  return result;
-}
-
-Bitboard MoveEngine::PawnNorthNorthMovesWithBlockers(
-    Bitboard board, const Bitboard& blocker_inverse) {
-  Bitboard result = board;
-  result |= board = (board << 8) & blocker_inverse;
-  result |= board = (board << 8) & blocker_inverse;
-  return result;
-}
-
-Bitboard MoveEngine::PawnSouthMovesWithBlockers(
-    Bitboard board, const Bitboard& blocker_inverse) {
-  Bitboard result = board;
-  result |= board = (board >> 8) & blocker_inverse;
-  return result;
-}
-
-Bitboard MoveEngine::PawnSouthSouthMovesWithBlockers(
-    Bitboard board, const Bitboard& blocker_inverse) {
-  Bitboard result = board;
-  result |= board = (board >> 8) & blocker_inverse;
-  result |= board = (board >> 8) & blocker_inverse;
-  return result;
-}
-
 std::vector<std::pair<char, int>> MoveEngine::BitStringToDescription(
     Bitboard board) {
   std::vector<int> indices = board.ToIndices();
@@ -205,8 +175,8 @@ Piece MoveEngine::IntToPiece(int integer) {
   return static_cast<Piece>(integer);
 }
 
-void MoveEngine::GenerateInitialState(std::vector<Bitboard>& white,
-                                      std::vector<Bitboard>& black) {
+void MoveEngine::GenerateInitialState(PieceBoards& white,
+                                      PieceBoards& black) {
   // Hand-calculated values for the initial chess state.
   white[PieceToInt(kKing)] = Bitboard().FromIndex(4);
   white[PieceToInt(kQueen)] = Bitboard().FromIndex(3);
@@ -237,7 +207,7 @@ void MoveEngine::GenerateInitialState(std::vector<Bitboard>& white,
       Bitboard().FromIndex(54) | Bitboard().FromIndex(55);
 }
 
-Bitboard MoveEngine::AllBitboardsInOneBoard(std::vector<Bitboard> boards) {
+Bitboard MoveEngine::AllBitboardsInOneBoard(const PieceBoards& boards) {
   return boards[static_cast<int>(kKing)] | boards[static_cast<int>(kQueen)] |
          boards[static_cast<int>(kRook)] | boards[static_cast<int>(kBishop)] |
          boards[static_cast<int>(kKnight)] | boards[static_cast<int>(kPawn)];
@@ -276,33 +246,64 @@ Bitboard MoveEngine::Moving(const Bitboard& board, Direction direction) {
 }
 
 Bitboard MoveEngine::KingMoves(const Bitboard& king, const Bitboard& self) {
+  Bitboard result;
+
+  for (int square : king) {
+    result |= AttackTables::KingAttacks(square);
+  }
+
   // The ~self ensures we do not move over our own piece.
-  return (Moving(king, kNorth) | Moving(king, kSouth) | Moving(king, kEast) |
-          Moving(king, kWest) | Moving(king, kNortheast) |
-          Moving(king, kNorthwest) | Moving(king, kSoutheast) |
-          Moving(king, kSouthwest)) &
-         (~self);
+  return result & ~self;
 }
 
 Bitboard MoveEngine::KnightMoves(const Bitboard& knight, const Bitboard& self) {
-  const Bitboard kAFileInverse(0xfefefefefefefefe);
-  const Bitboard kHFileInverse(0x7f7f7f7f7f7f7f7f);
-  const Bitboard kAbFileInverse(0xfcfcfcfcfcfcfcfc);
-  const Bitboard kGhFileInverse(0x3f3f3f3f3f3f3f3f);
-
-  return (((knight << 17) & kAFileInverse) |
-          ((knight >> 15) & kAFileInverse) |
-          ((knight << 15) & kHFileInverse) |
-          ((knight >> 17) & kHFileInverse) |
-          ((knight << 10) & kAbFileInverse) |
-          ((knight >> 6) & kAbFileInverse) |
-          ((knight >> 10) & kGhFileInverse) |
-          ((knight << 6) & kGhFileInverse)) &
-         (~self);
+  Bitboard result;
+
+  for (int square : knight) {
+    result |= AttackTables::KnightAttacks(square);
+  }
+
+  return result & ~self;
 }
 
 Bitboard MoveEngine::RookMoves(const Bitboard& rook, Bitboard self,
                                Bitboard enemy) {
+  const Bitboard occupancy = self | enemy;
+  Bitboard result;
+
+  for (int square : rook) {
+    result |= AttackTables::RookAttacks(square, occupancy);
+  }
+
+  return result & ~self;
+}
+
+Bitboard MoveEngine::BishopMoves(const Bitboard& bishop, Bitboard self,
+                                 Bitboard enemy) {
+  const Bitboard occupancy = self | enemy;
+  Bitboard result;
+
+  for (int square : bishop) {
+    result |= AttackTables::BishopAttacks(square, occupancy);
+  }
+
+  return result & ~self;
+}
+
+Bitboard MoveEngine::QueenMoves(const Bitboard& queen, Bitboard self,
+                                Bitboard enemy) {
+  const Bitboard occupancy = self | enemy;
+  Bitboard result;
+
+  for (int square : queen) {
+    result |= AttackTables::QueenAttacks(square, occupancy);
+  }
+
+  return result & ~self;
+}
+
+Bitboard MoveEngine::RookMovesByRays(const Bitboard& rook, Bitboard self,
+                                     Bitboard enemy) {
   self = ~self;
   enemy = ~enemy;
 
@@ -313,8 +314,8 @@ Bitboard MoveEngine::RookMoves(const Bitboard& rook, Bitboard self,
          rook;
 }
 
-Bitboard MoveEngine::BishopMoves(const Bitboard& bishop, Bitboard self,
-                                 Bitboard enemy) {
+Bitboard MoveEngine::BishopMovesByRays(const Bitboard& bishop, Bitboard self,
+                                       Bitboard enemy) {
   self = ~self;
   enemy = ~enemy;
 
@@ -329,74 +330,192 @@ Bitboard MoveEngine::BishopMoves(const Bitboard& bishop, Bitboard self,
          bishop;
 }
 
-Bitboard MoveEngine::QueenMoves(const Bitboard& queen, Bitboard self,
-                                Bitboard enemy) {
-  self = ~self;
-  enemy = ~enemy;
+bool MoveEngine::VerifySlidingAttacks() {
+  // Fixed xorshift stream so a failure reproduces.
+  uint64_t seed = 0x9e3779b97f4a7c15;
+
+  for (int square = 0; square < 64; square++) {
+    const Bitboard piece = Bitboard().FromIndex(square);
+
+    for (bool rook : {true, false}) {
+      const Bitboard lines =
+          rook ? RookMovesByRays(piece, Bitboard(), Bitboard())
+               : BishopMovesByRays(piece, Bitboard(), Bitboard());
+
+      // Enumerate every blocker subset on the lines through the square,
+      // splitting each one pseudo-randomly into friendly and enemy pieces.
+      uint64_t subset = 0;
+      do {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+
+        const Bitboard self(subset & seed);
+        const Bitboard enemy(subset & ~seed);
+        const Bitboard expected = rook ? RookMovesByRays(piece, self, enemy)
+                                       : BishopMovesByRays(piece, self, enemy);
+        const Bitboard actual = rook ? RookMoves(piece, self, enemy)
+                                     : BishopMoves(piece, self, enemy);
+
+        if (actual != expected ||
+            QueenMoves(piece, self, enemy) !=
+                (RookMovesByRays(piece, self, enemy) |
+                 BishopMovesByRays(piece, self, enemy))) {
+          return false;
+        }
+
+        subset = (subset - lines.board_) & lines.board_;
+      } while (subset);
+    }
+  }
 
-  return (NorthMovesWithBlockers(queen, self & Moving(enemy, kNorth)) |
-          SouthMovesWithBlockers(queen, self & Moving(enemy, kSouth)) |
-          WestMovesWithBlockers(queen, self & Moving(enemy, kWest)) |
-          EastMovesWithBlockers(queen, self & Moving(enemy, kEast)) |
-          NortheastMovesWithBlockers(queen,
-                                     self & Moving(enemy, kNortheast)) |
-          NorthwestMovesWithBlockers(queen,
-                                     self & Moving(enemy, kNorthwest)) |
-          SoutheastMovesWithBlockers(queen,
-                                     self & Moving(enemy, kSoutheast)) |
-          SouthwestMovesWithBlockers(queen,
-                                     self & Moving(enemy, kSouthwest))) ^
-         queen;
+  return true;
 }
 
 Bitboard MoveEngine::PawnMoves(const Bitboard& pawn, Bitboard self,
                                Bitboard enemy, Color self_color) {
-  const Bitboard enemy_original = enemy;
+  const Bitboard kThirdRank(0xff0000);
+  const Bitboard kSixthRank(0xff0000000000);
 
-  self = ~self;
-  enemy = ~enemy;
-
-  const Bitboard kSecondRank(0xff00);
-  const Bitboard kSeventhRank(0xff000000000000);
+  const Bitboard empty = ~(self | enemy);
+  Bitboard result;
 
+  // Pushes: one square into an empty square, and a second one from the
+  // starting rank when the first landed on the third (sixth) rank.
   if (self_color == kWhite) {
-    return (PawnNorthMovesWithBlockers(pawn, self & enemy) |
-            PawnNorthNorthMovesWithBlockers(pawn & kSecondRank, self & enemy) |
-            (Moving(pawn, kNortheast) & enemy_original) |
-            (Moving(pawn, kNorthwest) & enemy_original)) ^
-           pawn;
+    Bitboard single = (pawn << 8) & empty;
+    result |= single | (((single & kThirdRank) << 8) & empty);
   } else {
-    return (PawnSouthMovesWithBlockers(pawn, self & enemy) |
-            PawnSouthSouthMovesWithBlockers(pawn & kSeventhRank, self & enemy) |
-            (Moving(pawn, kSoutheast) & enemy_original) |
-            (Moving(pawn, kSouthwest) & enemy_original)) ^
-           pawn;
+    Bitboard single = (pawn >> 8) & empty;
+    result |= single | (((single & kSixthRank) >> 8) & empty);
+  }
+
+  for (int square : pawn) {
+    result |= AttackTables::PawnAttacks(self_color, square) & enemy;
+  }
+
+  return result;
+}
+
+bool MoveEngine::IsSquareAttacked(int square, Color by_color,
+                                  const PieceBoards& pieces,
+                                  const Bitboard& by_side,
+                                  const Bitboard& occupancy) {
+  const Bitboard kZeroBitboard(0);
+  const Color defender = static_cast<Color>((by_color + 1) % 2);
+
+  // Attacks are symmetric: a piece attacks the square exactly when the same
+  // piece standing on the square would attack it back. Pawns are the one
+  // exception, so look from the defender's point of view.
+  if ((AttackTables::PawnAttacks(defender, square) &
+       pieces[PieceToInt(kPawn)] & by_side) != kZeroBitboard ||
+      (AttackTables::KnightAttacks(square) & pieces[PieceToInt(kKnight)] &
+       by_side) != kZeroBitboard ||
+      (AttackTables::KingAttacks(square) & pieces[PieceToInt(kKing)] &
+       by_side) != kZeroBitboard) {
+    return true;
   }
+
+  const Bitboard& queens = pieces[PieceToInt(kQueen)];
+
+  return (AttackTables::RookAttacks(square, occupancy) &
+          (pieces[PieceToInt(kRook)] | queens) & by_side) != kZeroBitboard ||
+         (AttackTables::BishopAttacks(square, occupancy) &
+          (pieces[PieceToInt(kBishop)] | queens) & by_side) != kZeroBitboard;
+}
+
+Bitboard MoveEngine::AttackersTo(int square, const PieceBoards& pieces,
+                                 const Bitboard& whites, const Bitboard& blacks,
+                                 const Bitboard& occupancy) {
+  const Bitboard& pawns = pieces[PieceToInt(kPawn)];
+  const Bitboard& queens = pieces[PieceToInt(kQueen)];
+
+  return ((AttackTables::PawnAttacks(kBlack, square) & pawns & whites) |
+          (AttackTables::PawnAttacks(kWhite, square) & pawns & blacks) |
+          (AttackTables::KnightAttacks(square) & pieces[PieceToInt(kKnight)]) |
+          (AttackTables::KingAttacks(square) & pieces[PieceToInt(kKing)]) |
+          (AttackTables::RookAttacks(square, occupancy) &
+           (pieces[PieceToInt(kRook)] | queens)) |
+          (AttackTables::BishopAttacks(square, occupancy) &
+           (pieces[PieceToInt(kBishop)] | queens))) &
+         occupancy;
+}
+
+Bitboard MoveEngine::PinnedPieces(int king_square, const PieceBoards& pieces,
+                                  const Bitboard& self, const Bitboard& enemy) {
+  const Bitboard kZeroBitboard(0);
+  const Bitboard& queens = pieces[PieceToInt(kQueen)];
+
+  // Enemy sliders that would attack the king on an empty board.
+  Bitboard snipers =
+      ((AttackTables::RookAttacks(king_square, kZeroBitboard) &
+        (pieces[PieceToInt(kRook)] | queens)) |
+       (AttackTables::BishopAttacks(king_square, kZeroBitboard) &
+        (pieces[PieceToInt(kBishop)] | queens))) &
+      enemy;
+  Bitboard occupancy = self | enemy;
+
+  Bitboard pinned;
+  for (int sniper : snipers) {
+    Bitboard blockers =
+        AttackTables::Between(king_square, sniper) & occupancy;
+    if (blockers.PopCount() == 1) {
+      pinned |= blockers & self;
+    }
+  }
+
+  return pinned;
 }
 
 Bitboard MoveEngine::CastlingMoves(const Bitboard& castling_squares,
-                                   const Bitboard& all_white,
-                                   const Bitboard& all_blacks) {
-  const Bitboard kLongCastling(0x01);
-  const Bitboard kShortCastling(0x08);
+                                   const PieceBoards& pieces,
+                                   const Bitboard& self, const Bitboard& enemy,
+                                   Color self_color) {
+  const Bitboard kZeroBitboard(0);
+
+  // White's squares; black's are the same files on the eighth rank.
+  const int kKingHome = 4;
+  const int kLongRookHome = 0;
+  const int kShortRookHome = 7;
   const Bitboard kLongCastlingObstacles(0x0e);
   const Bitboard kShortCastlingObstacles(0x60);
+  const int kLongKingPath[] = {4, 3, 2};
+  const int kShortKingPath[] = {4, 5, 6};
+
+  int rank_offset = self_color == kWhite ? 0 : 56;
+  Color enemy_color = self_color == kWhite ? kBlack : kWhite;
+  Bitboard occupancy = self | enemy;
+  Bitboard rooks = pieces[PieceToInt(kRook)] & self & castling_squares;
+
+  if ((pieces[PieceToInt(kKing)] & self &
+       Bitboard().FromIndex(kKingHome + rank_offset)) == kZeroBitboard) {
+    return kZeroBitboard;
+  }
 
-  Bitboard obstacles = all_blacks | all_white;
-  Bitboard short_castling_from = castling_squares & kShortCastling;
-  Bitboard long_castling_from = castling_squares & kLongCastling;
+  auto path_is_safe = [&](const int (&path)[3]) {
+    for (int square : path) {
+      if (IsSquareAttacked(square + rank_offset, enemy_color, pieces, enemy,
+                           occupancy)) {
+        return false;
+      }
+    }
+    return true;
+  };
 
   Bitboard result;
 
-  // Calculate all castling squares (both white and black).
-  if ((obstacles & kLongCastlingObstacles) == Bitboard(0) &&
-      (long_castling_from & kLongCastling) != Bitboard(0)) {
-    result |= kLongCastling;
+  Bitboard long_rook = Bitboard().FromIndex(kLongRookHome + rank_offset);
+  if ((rooks & long_rook) != kZeroBitboard &&
+      (occupancy & (kLongCastlingObstacles << rank_offset)) == kZeroBitboard &&
+      path_is_safe(kLongKingPath)) {
+    result |= long_rook;
   }
 
-  if ((obstacles & kShortCastlingObstacles) == Bitboard(0) &&
-      (short_castling_from & kShortCastling) != Bitboard(0)) {
-    result |= kShortCastling;
+  Bitboard short_rook = Bitboard().FromIndex(kShortRookHome + rank_offset);
+  if ((rooks & short_rook) != kZeroBitboard &&
+      (occupancy & (kShortCastlingObstacles << rank_offset)) == kZeroBitboard &&
+      path_is_safe(kShortKingPath)) {
+    result |= short_rook;
   }
 
   return result;
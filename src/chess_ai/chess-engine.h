@@ -9,19 +9,25 @@
 #ifndef CHESS_AI_CHESS_ENGINE_H_
 #define CHESS_AI_CHESS_ENGINE_H_
 
+#include <array>
 #include <cstdint>
 #include <map>
 #include <utility>
 #include <vector>
 
 #include "action.h"
+#include "attack-tables.h"
 #include "bitboard.h"
 #include "chess-pieces.h"
 #include "color.h"
+#include "constants.h"
 #include "direction.h"
 
 namespace ChessEngine {
 
+// One bitboard per piece type, indexed by Piece.
+using PieceBoards = std::array<Bitboard, kNumberOfPieces>;
+
 class MoveEngine {
  public:
   static int PieceToInt(Piece piece);
@@ -29,19 +35,20 @@ class MoveEngine {
   static std::vector<std::pair<char, int>> BitStringToDescription(
       Bitboard board);
 
-  static void GenerateInitialState(std::vector<Bitboard>& white,
-                                   std::vector<Bitboard>& black);
-  static Bitboard AllBitboardsInOneBoard(std::vector<Bitboard> boards);
-
-  static Bitboard AllStandardMovesInOneBitboard(
-      const std::vector<Bitboard>& self_pieces, const Bitboard& self,
-      const Bitboard& enemy, Color self_color) {
-    return KingMoves(self_pieces[static_cast<int>(kKing)], self) |
-           QueenMoves(self_pieces[static_cast<int>(kQueen)], self, enemy) |
-           RookMoves(self_pieces[static_cast<int>(kRook)], self, enemy) |
-           BishopMoves(self_pieces[static_cast<int>(kBishop)], self, enemy) |
-           KnightMoves(self_pieces[static_cast<int>(kKnight)], self) |
-           PawnMoves(self_pieces[static_cast<int>(kPawn)], self, enemy,
+  static void GenerateInitialState(PieceBoards& white, PieceBoards& black);
+  static Bitboard AllBitboardsInOneBoard(const PieceBoards& boards);
+
+  // Pieces are shared piece-type boards; self selects the moving side.
+  static Bitboard AllStandardMovesInOneBitboard(const PieceBoards& pieces,
+                                                const Bitboard& self,
+                                                const Bitboard& enemy,
+                                                Color self_color) {
+    return KingMoves(pieces[static_cast<int>(kKing)] & self, self) |
+           QueenMoves(pieces[static_cast<int>(kQueen)] & self, self, enemy) |
+           RookMoves(pieces[static_cast<int>(kRook)] & self, self, enemy) |
+           BishopMoves(pieces[static_cast<int>(kBishop)] & self, self, enemy) |
+           KnightMoves(pieces[static_cast<int>(kKnight)] & self, self) |
+           PawnMoves(pieces[static_cast<int>(kPawn)] & self, self, enemy,
                      self_color);
   }
 
@@ -65,12 +72,45 @@ class MoveEngine {
   static Bitboard EnpassantMoves(const Bitboard& enemy_enpassant_squares,
                                  const Bitboard& self_pawns);
 
-  // Castling
+  // Returns true if any piece of by_color (the pieces inside by_side)
+  // attacks the square, with sliders blocked by occupancy. Only the rays and
+  // jumps that can reach the square are examined.
+  static bool IsSquareAttacked(int square, Color by_color,
+                               const PieceBoards& pieces,
+                               const Bitboard& by_side,
+                               const Bitboard& occupancy);
+
+  // Every piece of either color inside occupancy that attacks the square,
+  // with sliders blocked by occupancy. Removing a piece from occupancy
+  // uncovers the pieces lined up behind it.
+  static Bitboard AttackersTo(int square, const PieceBoards& pieces,
+                              const Bitboard& whites, const Bitboard& blacks,
+                              const Bitboard& occupancy);
+
+  // The pieces of self that shield self's king on king_square from an
+  // enemy slider, and so may only move along the line between them.
+  static Bitboard PinnedPieces(int king_square, const PieceBoards& pieces,
+                               const Bitboard& self, const Bitboard& enemy);
+
+  // Castling: the home squares of the rooks self can castle with now. The
+  // right must be held, king and rook must be home with only empty squares
+  // between them, and the king may not start on, pass or land on an
+  // attacked square.
   static Bitboard CastlingMoves(const Bitboard& castling_squares,
-                                const Bitboard& all_white,
-                                const Bitboard& all_blacks);
+                                const PieceBoards& pieces, const Bitboard& self,
+                                const Bitboard& enemy, Color self_color);
+
+  // Compares the sliding attack tables against the ray-shifting reference
+  // for every blocker subset of every square. Returns true if they agree.
+  static bool VerifySlidingAttacks();
 
  private:
+  // Shift-and-mask reference implementations of the sliding moves.
+  static Bitboard RookMovesByRays(const Bitboard& rook, Bitboard self,
+                                  Bitboard enemy);
+  static Bitboard BishopMovesByRays(const Bitboard& bishop, Bitboard self,
+                                    Bitboard enemy);
+
   static Bitboard NorthMovesWithBlockers(Bitboard board,
                                          const Bitboard& blocker_inverse);
   static Bitboard SouthMovesWithBlockers(Bitboard board,
@@ -87,15 +127,6 @@ class MoveEngine {
                                              const Bitboard& blocker_inverse);
   static Bitboard SouthwestMovesWithBlockers(Bitboard board,
                                              const Bitboard& blocker_inverse);
-
-  static Bitboard PawnNorthMovesWithBlockers(Bitboard board,
-                                             const Bitboard& blocker_inverse);
-  static Bitboard PawnNorthNorthMovesWithBlockers(
-      Bitboard board, const Bitboard& blocker_inverse);
-  static Bitboard PawnSouthMovesWithBlockers(Bitboard board,
-                                             const Bitboard& blocker_inverse);
-  static Bitboard PawnSouthSouthMovesWithBlockers(
-      Bitboard board, const Bitboard& blocker_inverse);
 };
 
 }  // namespace ChessEngine
@@ -14,6 +14,8 @@
 #include "chess-engine.h"
 #include "chess-pieces.h"
 #include "color.h"
+#include "evaluation.h"
+#include "pawn-hash-table.h"
 #include "state.h"
 
 namespace ChessEngine {
@@ -22,6 +24,10 @@ template <class T>
 class ChessAIHeuristic {
  public:
   static T MaterialAdvantage(const State& state, Color player_color);
+  // The tapered evaluation in pawns, from player_color's point of view.
+  // Pawn structure is looked up in, and added to, pawn_table if given.
+  static T Evaluate(const State& state, Color player_color,
+                    PawnHashTable* pawn_table = nullptr);
 };
 
 template <class T>
@@ -36,16 +42,10 @@ T ChessAIHeuristic<T>::MaterialAdvantage(const State& state,
     Piece piece = element.first;
     int piece_weight = element.second;
 
-    int num_friendly = player_color == kWhite
-                           ? state.whites_[MoveEngine::PieceToInt(piece)]
-                                 .NumberOfBits()
-                           : state.blacks_[MoveEngine::PieceToInt(piece)]
-                                 .NumberOfBits();
-    int num_enemy = player_color == kWhite
-                        ? state.blacks_[MoveEngine::PieceToInt(piece)]
-                              .NumberOfBits()
-                        : state.whites_[MoveEngine::PieceToInt(piece)]
-                              .NumberOfBits();
+    int num_friendly = state.Pieces(player_color, piece).PopCount();
+    int num_enemy =
+        state.Pieces(static_cast<Color>((player_color + 1) % 2), piece)
+            .PopCount();
 
     T difference =
         static_cast<T>(piece_weight) * (num_friendly - num_enemy);
@@ -55,6 +55,17 @@ T ChessAIHeuristic<T>::MaterialAdvantage(const State& state,
   return value;
 }
 
+template <class T>
+T ChessAIHeuristic<T>::Evaluate(const State& state, Color player_color,
+                               PawnHashTable* pawn_table) {
+  int centipawns = Evaluation::Evaluate(state, pawn_table);
+  if (player_color == kBlack) {
+    centipawns = -centipawns;
+  }
+
+  return static_cast<T>(centipawns) / 100;
+}
+
 }  // namespace ChessEngine
 
 #endif  // CHESS_AI_CHESS_HEURISTIC_H_
@@ -9,42 +9,84 @@
 #ifndef CHESS_AI_CHESS_HISTORY_H_
 #define CHESS_AI_CHESS_HISTORY_H_
 
-#include <deque>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
 
-#include "constants.h"
+#include "action.h"
 #include "state.h"
 
 namespace ChessEngine {
 
+// The positions of the game so far, newest last, as Zobrist keys with the
+// halfmove clock (plies since the last capture or pawn move) of each. The
+// search adds a position on every make and removes it on every unmake, so
+// a node costs no copies.
 class PerceptSequence {
  public:
-  void Add(const State& state) {
-    if (state_history_.size() > kMaxHistory) {
-      state_history_.pop_front();
-    }
-    state_history_.push_back(state);
+  PerceptSequence() { entries_.reserve(kReservedPlies); }
+
+  PerceptSequence(const State& state, int halfmove_clock) : PerceptSequence() {
+    entries_.push_back({state.key_, halfmove_clock, 0});
+  }
+
+  // Records the state action led to.
+  void Add(const State& state, const Action& action) {
+    bool irreversible = action.WasCapture() || action.GetPiece() == kPawn;
+    int clock = irreversible ? 0 : HalfmoveClock() + 1;
+    int plies_since_null = Empty() ? 0 : entries_.back().plies_since_null + 1;
+
+    entries_.push_back({state.key_, clock, plies_since_null});
   }
 
-  void Add(const Action& action) {
-    moves_since_capture_ = action.WasCapture() ? moves_since_capture_ + 1 : 0;
-    moves_since_pawn_movement_ =
-        action.GetPiece() == kPawn ? moves_since_pawn_movement_ + 1 : 0;
+  // Records the state a null move led to. Nothing before a null move can
+  // be repeated after it, as it was not a legal move.
+  void AddNullMove(const State& state) {
+    entries_.push_back({state.key_, HalfmoveClock() + 1, 0});
   }
 
-  const State operator[](int index) const { return state_history_[index]; }
+  // Undoes the newest Add or AddNullMove.
+  void Pop() { entries_.pop_back(); }
+
+  // Whether the newest position occurred before. Only positions since the
+  // last irreversible move can match, and only every other one has the
+  // same side to move.
+  bool IsRepetition() const {
+    if (Empty()) {
+      return false;
+    }
+
+    const Entry& newest = entries_.back();
+    int window = std::min(newest.halfmove_clock, newest.plies_since_null);
+    int size = static_cast<int>(entries_.size());
 
-  int MovesSincePawnMovement() const noexcept {
-    return moves_since_pawn_movement_;
+    // Each side needs at least two moves to come back to a position.
+    for (int back = 4; back <= window && back < size; back += 2) {
+      if (entries_[size - 1 - back].key == newest.key) {
+        return true;
+      }
+    }
+    return false;
   }
 
-  int MovesSinceCapture() const noexcept { return moves_since_capture_; }
+  int HalfmoveClock() const noexcept {
+    return Empty() ? 0 : entries_.back().halfmove_clock;
+  }
 
-  size_t Size() const noexcept { return state_history_.size(); }
+  bool Empty() const noexcept { return entries_.empty(); }
+  size_t Size() const noexcept { return entries_.size(); }
 
  private:
-  std::deque<State> state_history_;
-  int moves_since_capture_ = 0;
-  int moves_since_pawn_movement_ = 0;
+  struct Entry {
+    uint64_t key;
+    int halfmove_clock;
+    int plies_since_null;
+  };
+
+  // Enough for a long game and a full depth search below it.
+  static const int kReservedPlies = 1024;
+
+  std::vector<Entry> entries_;
 };
 
 }  // namespace ChessEngine
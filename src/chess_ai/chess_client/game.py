@@ -3,8 +3,10 @@
 from __future__ import annotations
 
 import os
+import queue
 import re
 import subprocess
+import threading
 import typing
 
 
@@ -48,6 +50,10 @@ class ChessGame:
             script_dir = os.path.dirname(parent_dir)
             self.ai_path = os.path.join(script_dir, "chess_ai")
 
+        # Persistent engine process speaking UCI, started on first use
+        self._engine: typing.Optional[subprocess.Popen] = None
+        self._engine_lines: "queue.Queue[typing.Optional[str]]" = queue.Queue()
+
         # Game state
         self.board: typing.List[typing.List[str]] = [[""]*8 for _ in range(8)]
         self.turn: str = "white"
@@ -507,22 +513,14 @@ class ChessGame:
         fen = self.to_fen()
 
         try:
-            # Build command with optional --worst flag.
-            cmd = [self.ai_path]
-            if self.worst_mode:
-                cmd.append("--worst")
-            cmd.append(fen)
-
-            result = subprocess.run(
-                cmd,
-                capture_output=True,
-                text=True,
-                timeout=self.ai_time + 10
-            )
+            self._send_to_engine(f"position fen {fen}")
+            self._send_to_engine(f"go movetime {int(self.ai_time * 1000)}")
 
-            # Parse output to find move
-            # Expected format: "e2 -> e4" or "e7 -> e8=Q" for promotion
-            output = result.stdout
+            # Expected format: "bestmove e2e4" or "bestmove e7e8q"
+            output = self._read_from_engine("bestmove", self.ai_time + 10)
+            if output is None:
+                self.close()
+                return None
 
             # Try different patterns
             patterns = [
@@ -557,11 +555,102 @@ class ChessGame:
 
             return None
 
-        except subprocess.TimeoutExpired:
+        except (OSError, ValueError):
+            self.close()
             return None
         except Exception:
             return None
 
+    def _start_engine(self) -> subprocess.Popen:
+        """Start the engine in UCI mode and wait until it is ready.
+
+        Returns:
+            The running engine process.
+        """
+        cmd = [self.ai_path, "--uci"]
+        if self.worst_mode:
+            cmd.append("--worst")
+
+        engine = subprocess.Popen(
+            cmd,
+            stdin=subprocess.PIPE,
+            stdout=subprocess.PIPE,
+            stderr=subprocess.DEVNULL,
+            text=True,
+            bufsize=1,
+        )
+        self._engine = engine
+        self._engine_lines = queue.Queue()
+
+        # Read on a thread so waiting for a reply can time out.
+        def pump(lines: "queue.Queue[typing.Optional[str]]") -> None:
+            for line in engine.stdout:
+                lines.put(line.strip())
+            lines.put(None)
+
+        threading.Thread(
+            target=pump, args=(self._engine_lines,), daemon=True
+        ).start()
+
+        self._send_to_engine("uci")
+        if self._read_from_engine("uciok", 10) is None:
+            raise OSError("engine did not answer uci")
+        self._send_to_engine("isready")
+        if self._read_from_engine("readyok", 10) is None:
+            raise OSError("engine did not answer isready")
+
+        return engine
+
+    def _send_to_engine(self, command: str) -> None:
+        """Send one command to the engine, starting it if needed.
+
+        Args:
+            command: UCI command without the trailing newline.
+        """
+        if self._engine is None or self._engine.poll() is not None:
+            self._engine = None
+            self._start_engine()
+        assert self._engine is not None and self._engine.stdin is not None
+        self._engine.stdin.write(command + "\n")
+        self._engine.stdin.flush()
+
+    def _read_from_engine(
+        self, prefix: str, timeout: float
+    ) -> typing.Optional[str]:
+        """Wait for the first engine line starting with prefix.
+
+        Args:
+            prefix: Start of the reply to wait for.
+            timeout: Seconds to wait.
+
+        Returns:
+            The matching line, or None on timeout or engine exit.
+        """
+        try:
+            while True:
+                line = self._engine_lines.get(timeout=timeout)
+                if line is None:
+                    return None
+                if line.startswith(prefix):
+                    return line
+        except queue.Empty:
+            return None
+
+    def close(self) -> None:
+        """Shut down the engine process if one is running."""
+        engine, self._engine = self._engine, None
+        if engine is None:
+            return
+
+        try:
+            if engine.poll() is None and engine.stdin is not None:
+                engine.stdin.write("quit\n")
+                engine.stdin.flush()
+            engine.wait(timeout=2)
+        except (OSError, ValueError, subprocess.TimeoutExpired):
+            engine.kill()
+            engine.wait()
+
     def find_king(
         self, is_white: bool
     ) -> typing.Optional[typing.Tuple[int, int]]:
@@ -421,6 +421,7 @@ class ChessClient:
         except KeyboardInterrupt:
             pass
         finally:
+            self.game.close()
             self.console.print("\nThanks for playing!")
 
 
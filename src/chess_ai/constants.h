@@ -11,8 +11,20 @@
 
 namespace ChessEngine {
 
-const int kMaxHistory = 8;
 const int kNumberOfPieces = 6;
+const int kMaxSearchDepth = 64;
+// Quiescence only follows captures and promotions, so sequences this long
+// are rare; the limit guards against pathological piles of them.
+const int kQuiescenceLimit = 8;
+// Deepest node below the root, quiescence included.
+const int kMaxSearchPly = kMaxSearchDepth + kQuiescenceLimit;
+
+// Exchange values in centipawns, indexed by Piece. The king outweighs any
+// material it could win back.
+const int kPieceValues[kNumberOfPieces] = {20000, 900, 500, 300, 300, 100};
+
+const char kStartingFen[] =
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
 
 }  // namespace ChessEngine
 
@@ -0,0 +1,273 @@
+//
+//  evaluation.cpp
+//  chess_ai
+//
+//  Created by Illya Starikov on 10/14/26.
+//  Copyright 2026. Illya Starikov. All rights reserved.
+//
+
+#include "evaluation.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+
+#include "attack-tables.h"
+
+namespace ChessEngine {
+
+namespace {
+
+const Score kDoubledPawn = {-10, -20};
+const Score kIsolatedPawn = {-15, -10};
+// Left behind by its neighbours, with its next square held by an enemy pawn.
+const Score kBackwardPawn = {-8, -10};
+// Indexed by rank from the pawn's own side: the further up, the more it is
+// worth, most of all once the pieces that could stop it are gone.
+const Score kPassedPawn[8] = {{0, 0},   {5, 10},  {10, 20},  {15, 35},
+                              {25, 60}, {40, 100}, {60, 150}, {0, 0}};
+const Score kBlockedPassedPawn = {-5, -25};
+
+// Indexed by how far in front of the king the pawn stands.
+const Score kPawnShield[3] = {{0, 0}, {12, 0}, {6, 0}};
+const Score kOpenFileNearKing = {-25, 0};
+const Score kSemiOpenFileNearKing = {-12, 0};
+
+const Score kBishopPair = {30, 50};
+
+// Per square reached, and the count a piece on a typical square reaches.
+const Score kKnightMobility = {4, 4};
+const Score kBishopMobility = {5, 5};
+const Score kRookMobility = {2, 4};
+const Score kQueenMobility = {1, 2};
+const int kKnightSquares = 4;
+const int kBishopSquares = 6;
+const int kRookSquares = 7;
+const int kQueenSquares = 13;
+
+constexpr uint64_t kFileA = 0x0101010101010101ULL;
+constexpr uint64_t kFileH = kFileA << 7;
+
+constexpr std::array<uint64_t, 8> AdjacentFilesTable() {
+  std::array<uint64_t, 8> table{};
+
+  for (int file = 0; file < 8; file++) {
+    if (file > 0) {
+      table[file] |= kFileA << (file - 1);
+    }
+    if (file < 7) {
+      table[file] |= kFileA << (file + 1);
+    }
+  }
+
+  return table;
+}
+
+// The squares in front of a square on its own and the adjacent files, as
+// seen from color's side. No enemy pawn there makes a pawn passed.
+constexpr std::array<uint64_t, 64> FrontSpanTable(Color color) {
+  std::array<uint64_t, 64> table{};
+
+  for (int square = 0; square < 64; square++) {
+    int file = square % 8;
+    int rank = square / 8;
+
+    for (int other = 0; other < 64; other++) {
+      int other_file = other % 8;
+      int other_rank = other / 8;
+      bool ahead = color == kWhite ? other_rank > rank : other_rank < rank;
+      int file_distance = other_file > file ? other_file - file
+                                            : file - other_file;
+
+      if (ahead && file_distance <= 1) {
+        table[square] |= 1ULL << other;
+      }
+    }
+  }
+
+  return table;
+}
+
+constexpr std::array<uint64_t, 8> kAdjacentFiles = AdjacentFilesTable();
+constexpr std::array<uint64_t, 64> kFrontSpans[2] = {FrontSpanTable(kWhite),
+                                                     FrontSpanTable(kBlack)};
+
+int RelativeRank(Color color, int square) {
+  return color == kWhite ? square / 8 : 7 - square / 8;
+}
+
+// Every square a side's pawns attack.
+uint64_t PawnAttacks(Color color, uint64_t pawns) {
+  if (color == kWhite) {
+    return ((pawns << 7) & ~kFileH) | ((pawns << 9) & ~kFileA);
+  }
+  return ((pawns >> 7) & ~kFileA) | ((pawns >> 9) & ~kFileH);
+}
+
+// One side's doubled, isolated, backward and passed pawns.
+Score SidePawnStructure(Color color, uint64_t pawns, uint64_t enemy_pawns,
+                        Bitboard& passed) {
+  Color enemy_color = static_cast<Color>((color + 1) % 2);
+  uint64_t enemy_attacks = PawnAttacks(enemy_color, enemy_pawns);
+
+  Score score{0, 0};
+
+  for (int file = 0; file < 8; file++) {
+    int on_file = __builtin_popcountll(pawns & (kFileA << file));
+    if (on_file > 1) {
+      score += kDoubledPawn * (on_file - 1);
+    }
+  }
+
+  passed = Bitboard(0);
+  for (int square : Bitboard(pawns)) {
+    uint64_t neighbours = pawns & kAdjacentFiles[square % 8];
+    if (neighbours == 0) {
+      score += kIsolatedPawn;
+    } else {
+      // Neighbours on its rank or behind it could still step up in support.
+      uint64_t rank = 0xffULL << (8 * (square / 8));
+      uint64_t supporters =
+          neighbours & (kFrontSpans[enemy_color][square] | rank);
+      int stop = color == kWhite ? square + 8 : square - 8;
+
+      if (supporters == 0 && (enemy_attacks >> stop & 1) != 0) {
+        score += kBackwardPawn;
+      }
+    }
+
+    if ((enemy_pawns & kFrontSpans[color][square]) == 0) {
+      score += kPassedPawn[RelativeRank(color, square)];
+      passed.board_ |= 1ULL << square;
+    }
+  }
+
+  return score;
+}
+
+}  // namespace
+
+int Evaluation::Evaluate(const State& state, PawnHashTable* pawn_table) {
+  Score score = state.psqt_;
+
+  PawnEntry pawns;
+  if (pawn_table == nullptr || !pawn_table->Probe(state.pawn_key_, pawns)) {
+    pawns.key = state.pawn_key_;
+    pawns.score = PawnStructure(state, pawns.passed);
+    if (pawn_table != nullptr) {
+      pawn_table->Store(pawns);
+    }
+  }
+
+  score += pawns.score;
+  const Bitboard* passed = pawns.passed;
+
+  score += KingSafety(state, kWhite) - KingSafety(state, kBlack);
+  score += Mobility(state, kWhite) - Mobility(state, kBlack);
+  score += BlockedPassedPawns(state, kWhite, passed[kWhite]) -
+           BlockedPassedPawns(state, kBlack, passed[kBlack]);
+
+  if (state.Pieces(kWhite, kBishop).PopCount() >= 2) {
+    score += kBishopPair;
+  }
+  if (state.Pieces(kBlack, kBishop).PopCount() >= 2) {
+    score -= kBishopPair;
+  }
+
+  return Taper(score, state.phase_);
+}
+
+Score Evaluation::PawnStructure(const State& state, Bitboard passed[2]) {
+  uint64_t white_pawns = state.Pieces(kWhite, kPawn).board_;
+  uint64_t black_pawns = state.Pieces(kBlack, kPawn).board_;
+
+  return SidePawnStructure(kWhite, white_pawns, black_pawns, passed[kWhite]) -
+         SidePawnStructure(kBlack, black_pawns, white_pawns, passed[kBlack]);
+}
+
+Score Evaluation::KingSafety(const State& state, Color color) {
+  Color enemy_color = static_cast<Color>((color + 1) % 2);
+  uint64_t kings = state.Pieces(color, kKing).board_;
+  if (kings == 0) {
+    return {0, 0};
+  }
+
+  int king = __builtin_ctzll(kings);
+  uint64_t pawns = state.Pieces(color, kPawn).board_;
+  uint64_t enemy_pawns = state.Pieces(enemy_color, kPawn).board_;
+
+  Score score{0, 0};
+
+  for (int square : Bitboard(pawns & kFrontSpans[color][king])) {
+    int distance = std::abs(square / 8 - king / 8);
+    if (distance < 3) {
+      score += kPawnShield[distance];
+    }
+  }
+
+  int king_file = king % 8;
+  for (int file = std::max(king_file - 1, 0);
+       file <= std::min(king_file + 1, 7); file++) {
+    uint64_t mask = kFileA << file;
+    if ((pawns & mask) != 0) {
+      continue;
+    }
+    score += (enemy_pawns & mask) == 0 ? kOpenFileNearKing
+                                       : kSemiOpenFileNearKing;
+  }
+
+  return score;
+}
+
+Score Evaluation::Mobility(const State& state, Color color) {
+  Color enemy_color = static_cast<Color>((color + 1) % 2);
+  Bitboard occupancy = state.AllPieces();
+  uint64_t safe =
+      ~state.Occupancy(color).board_ &
+      ~PawnAttacks(enemy_color, state.Pieces(enemy_color, kPawn).board_);
+
+  Score score{0, 0};
+
+  for (int square : state.Pieces(color, kKnight)) {
+    uint64_t reached = AttackTables::KnightAttacks(square).board_ & safe;
+    score += kKnightMobility *
+             (__builtin_popcountll(reached) - kKnightSquares);
+  }
+  for (int square : state.Pieces(color, kBishop)) {
+    uint64_t reached =
+        AttackTables::BishopAttacks(square, occupancy).board_ & safe;
+    score += kBishopMobility *
+             (__builtin_popcountll(reached) - kBishopSquares);
+  }
+  for (int square : state.Pieces(color, kRook)) {
+    uint64_t reached =
+        AttackTables::RookAttacks(square, occupancy).board_ & safe;
+    score += kRookMobility * (__builtin_popcountll(reached) - kRookSquares);
+  }
+  for (int square : state.Pieces(color, kQueen)) {
+    uint64_t reached =
+        AttackTables::QueenAttacks(square, occupancy).board_ & safe;
+    score += kQueenMobility *
+             (__builtin_popcountll(reached) - kQueenSquares);
+  }
+
+  return score;
+}
+
+Score Evaluation::BlockedPassedPawns(const State& state, Color color,
+                                     const Bitboard& passed) {
+  uint64_t stops = color == kWhite ? passed.board_ << 8 : passed.board_ >> 8;
+  int blocked = __builtin_popcountll(stops & state.AllPieces().board_);
+
+  return kBlockedPassedPawn * blocked;
+}
+
+int Evaluation::Taper(const Score& score, int phase) {
+  // Promotions can add phase past the starting position's.
+  phase = std::min(phase, kMaxPhase);
+  return (score.middlegame * phase + score.endgame * (kMaxPhase - phase)) /
+         kMaxPhase;
+}
+
+}  // namespace ChessEngine
@@ -0,0 +1,53 @@
+//
+//  evaluation.h
+//  chess_ai
+//
+//  Created by Illya Starikov on 10/14/26.
+//  Copyright 2026. Illya Starikov. All rights reserved.
+//
+
+#ifndef CHESS_AI_EVALUATION_H_
+#define CHESS_AI_EVALUATION_H_
+
+#include "bitboard.h"
+#include "color.h"
+#include "pawn-hash-table.h"
+#include "piece-square-tables.h"
+#include "state.h"
+
+namespace ChessEngine {
+
+// Static evaluation in centipawns from white's point of view. Every term
+// has a middlegame and an endgame weight, blended by the game phase, so
+// the engine moves from king shelter to king activity and pawn races as
+// material comes off. Material and piece squares come from State, which
+// keeps them current move by move; the rest is computed here.
+class Evaluation {
+ public:
+  // Pawn structure comes from pawn_table when it holds the formation, and
+  // is stored there otherwise.
+  static int Evaluate(const State& state, PawnHashTable* pawn_table = nullptr);
+
+  // Doubled, isolated, backward and passed pawns, white's minus black's.
+  // Depends on the pawns alone; passed is filled with each side's passed
+  // pawns.
+  static Score PawnStructure(const State& state, Bitboard passed[2]);
+
+  // Pawn shelter in front of color's king and open files next to it.
+  static Score KingSafety(const State& state, Color color);
+
+  // Squares color's knights, bishops, rooks and queens reach that are not
+  // their own nor covered by an enemy pawn, against a typical count.
+  static Score Mobility(const State& state, Color color);
+
+  // Passed pawns whose next square is taken, which are worth far less.
+  static Score BlockedPassedPawns(const State& state, Color color,
+                                  const Bitboard& passed);
+
+  // Blends score by phase: all middlegame at kMaxPhase, all endgame at 0.
+  static int Taper(const Score& score, int phase);
+};
+
+}  // namespace ChessEngine
+
+#endif  // CHESS_AI_EVALUATION_H_
@@ -8,172 +8,326 @@
 
 #include "fen-parser.h"
 
+#include <algorithm>
 #include <stdexcept>
 
 namespace ChessEngine {
 
-std::string FenParser::GetToken(FenToken token) {
-  const auto regex_string =
-      R"((([pPnNbBrRqQkK0-8]{1,8}/?){8})\s*(w|b)\s*([KQkq-]{0,4})\s*([a-hA-H0-8\-]{1,2})\s*(\d+)\s*(\d+)*)";
-  auto regex_expression = std::regex(regex_string);
-  std::smatch match;
-
-  if (std::regex_search(fen_string_, match, regex_expression)) {
-    switch (token) {
-      case kBoard:
-        return match[1];
-      case kColorAtPlay:
-        return match[3];  // Offset due to regex capture groups.
-      case kCastling:
-        return match[4];
-      case kEnPassant:
-        return match[5];
-      case kHalfTurns:
-        return match[6];
-      case kFullTurns:
-        return match[7];
-      default:
-        throw std::logic_error("Invalid FEN token");
+namespace {
+
+const char kPieceLetters[] = "kqrbnp";
+
+// The piece a FEN letter names, of either case, or -1.
+int PieceIndex(char letter) {
+  char lowercase = letter >= 'A' && letter <= 'Z' ? letter - 'A' + 'a' : letter;
+  for (int i = 0; i < kNumberOfPieces; i++) {
+    if (kPieceLetters[i] == lowercase) {
+      return i;
     }
-  } else {
-    std::cout << fen_string_;
-    throw std::logic_error("Invalid FEN string format");
   }
+  return -1;
 }
 
-void FenParser::ParseBoard(std::vector<Bitboard>& white_bitboard,
-                           std::vector<Bitboard>& black_bitboard) {
-  std::string token = GetToken(kBoard);
-  token.erase(std::remove(token.begin(), token.end(), '/'), token.end());
-
-  std::map<char, std::pair<Color, Piece>> pieces = {
-      {'P', std::make_pair(kWhite, kPawn)},
-      {'N', std::make_pair(kWhite, kKnight)},
-      {'B', std::make_pair(kWhite, kBishop)},
-      {'R', std::make_pair(kWhite, kRook)},
-      {'Q', std::make_pair(kWhite, kQueen)},
-      {'K', std::make_pair(kWhite, kKing)},
-      {'p', std::make_pair(kBlack, kPawn)},
-      {'n', std::make_pair(kBlack, kKnight)},
-      {'b', std::make_pair(kBlack, kBishop)},
-      {'r', std::make_pair(kBlack, kRook)},
-      {'q', std::make_pair(kBlack, kQueen)},
-      {'k', std::make_pair(kBlack, kKing)}};
-
-  int i = 0;
-  for (const char& ch : token) {
-    // Convert from FEN top-left indexing to bitboard bottom-left indexing.
-    int bitboard_index = (8 * ((63 - i) / 8) + (i % 8));
-
-    if (isdigit(ch)) {
-      i += static_cast<int>(ch) - 48 - 1;
-    } else if (pieces.find(ch) != pieces.end()) {
-      auto result = pieces[ch];
-
-      if (result.first == kWhite) {
-        white_bitboard[MoveEngine::PieceToInt(result.second)] |=
-            Bitboard().FromIndex(bitboard_index);
-      } else if (result.first == kBlack) {
-        black_bitboard[MoveEngine::PieceToInt(result.second)] |=
-            Bitboard().FromIndex(bitboard_index);
-      } else {
-        throw std::logic_error("FEN parser: color is not white or black");
-      }
-    } else {
-      throw std::logic_error("Illegal character in FEN string");
+// Walks one FEN string; each Read step fails at the first character that
+// does not fit and leaves the column on it.
+class FenCursor {
+ public:
+  explicit FenCursor(const std::string& fen) : fen_(fen), column_(0) {}
+
+  size_t Column() const { return column_; }
+  bool AtEnd() const { return column_ >= fen_.size(); }
+  char Peek() const { return AtEnd() ? '\0' : fen_[column_]; }
+  char Next() { return AtEnd() ? '\0' : fen_[column_++]; }
+
+  // At least one space, unless the string ends here.
+  bool SkipSpaces() {
+    if (Peek() != ' ' && Peek() != '\t') {
+      return false;
     }
+    while (Peek() == ' ' || Peek() == '\t') {
+      column_++;
+    }
+    return true;
+  }
 
-    i++;
+  // A counter from 0 to kMaxCounter. On failure the column is left on the
+  // first digit.
+  bool ReadNumber(short& number) {
+    const int kMaxCounter = 9999;
+
+    size_t start = column_;
+    int value = 0;
+    while (Peek() >= '0' && Peek() <= '9') {
+      value = std::min(10 * value + (Next() - '0'), kMaxCounter + 1);
+    }
+    if (column_ == start || value > kMaxCounter) {
+      column_ = start;
+      return false;
+    }
+    number = static_cast<short>(value);
+    return true;
   }
+
+ private:
+  const std::string& fen_;
+  size_t column_;
+};
+
+bool Fail(FenError& error, size_t column, const char* message) {
+  error = {column, message};
+  return false;
 }
 
-Color FenParser::ParseColorAtPlay() {
-  std::string token = GetToken(kColorAtPlay);
-  return (token == "w") ? kWhite : kBlack;
+}  // namespace
+
+State FenParser::operator()(const std::string& fen_string) {
+  State state;
+  FenError error;
+
+  if (!Parse(fen_string, state, error)) {
+    throw std::logic_error(std::string(error.message) + " at column " +
+                           std::to_string(error.column) + " of \"" +
+                           fen_string + "\"");
+  }
+  return state;
 }
 
-Bitboard FenParser::ParseCastling() {
-  const Bitboard kWhiteShortSide(0x80);
-  const Bitboard kWhiteLongSide(0x01);
-  const Bitboard kBlackShortSide(0x8000000000000000);
-  const Bitboard kBlackLongSide(0x100000000000000);
+bool FenParser::Parse(const std::string& fen_string, State& state,
+                      FenError& error) {
+  FenCursor cursor(fen_string);
+  PieceBoards whites;
+  PieceBoards blacks;
+  whites.fill(Bitboard(0));
+  blacks.fill(Bitboard(0));
+
+  while (cursor.Peek() == ' ') {
+    cursor.Next();
+  }
+
+  // Ranks run from 8 down to 1, files from a to h.
+  for (int rank = 7; rank >= 0; rank--) {
+    int file = 0;
+    bool after_count = false;
+    while (file < 8) {
+      size_t column = cursor.Column();
+      char ch = cursor.Next();
+      int piece = PieceIndex(ch);
 
-  const Bitboard kZeroBitboard(0);
+      if (ch >= '1' && ch <= '8') {
+        if (after_count) {
+          return Fail(error, column, "two empty counts in a row");
+        }
+        file += ch - '0';
+        after_count = true;
+      } else if (piece >= 0) {
+        PieceBoards& side = ch >= 'a' ? blacks : whites;
+        side[piece] |= Bitboard(uint64_t{1} << (8 * rank + file));
+        file++;
+        after_count = false;
+      } else {
+        return Fail(error, column, "expected a piece or an empty count");
+      }
 
-  std::string token = GetToken(kCastling);
-  Bitboard result = kZeroBitboard;
+      if (file > 8) {
+        return Fail(error, column, "rank holds more than eight squares");
+      }
+    }
 
-  if (token.find("Q") != std::string::npos) {
-    result |= kWhiteLongSide;
+    if (rank > 0 && cursor.Next() != '/') {
+      return Fail(error, cursor.Column() - 1, "expected '/' after a rank");
+    }
   }
-  if (token.find("K") != std::string::npos) {
-    result |= kWhiteShortSide;
+
+  const int kKingIndex = MoveEngine::PieceToInt(kKing);
+  if (whites[kKingIndex].PopCount() != 1 ||
+      blacks[kKingIndex].PopCount() != 1) {
+    return Fail(error, 0, "each side needs exactly one king");
   }
-  if (token.find("q") != std::string::npos) {
-    result |= kBlackLongSide;
+
+  if (!cursor.SkipSpaces()) {
+    return Fail(error, cursor.Column(), "expected a space after the board");
   }
-  if (token.find("k") != std::string::npos) {
-    result |= kBlackShortSide;
+  Color color_at_play;
+  char color = cursor.Next();
+  if (color == 'w') {
+    color_at_play = kWhite;
+  } else if (color == 'b') {
+    color_at_play = kBlack;
+  } else {
+    return Fail(error, cursor.Column() - 1, "expected w or b to move");
   }
 
-  return result;
-}
-
-Bitboard FenParser::ParseEnPassant() {
-  std::string token = GetToken(kEnPassant);
-  const Bitboard kZeroBitboard(0);
-
-  if (token == "-") {
-    return kZeroBitboard;
+  if (!cursor.SkipSpaces()) {
+    return Fail(error, cursor.Column(), "expected a space after the color");
   }
+  // Rights are kept as the home squares of the rooks that may castle.
+  uint64_t castling = 0;
+  if (cursor.Peek() == '-') {
+    cursor.Next();
+  } else {
+    while (cursor.Peek() != ' ' && !cursor.AtEnd()) {
+      size_t column = cursor.Column();
+      switch (cursor.Next()) {
+        case 'K':
+          castling |= uint64_t{1} << 7;
+          break;
+        case 'Q':
+          castling |= uint64_t{1} << 0;
+          break;
+        case 'k':
+          castling |= uint64_t{1} << 63;
+          break;
+        case 'q':
+          castling |= uint64_t{1} << 56;
+          break;
+        default:
+          return Fail(error, column, "expected castling rights KQkq or -");
+      }
+    }
+    if (castling == 0) {
+      return Fail(error, cursor.Column(), "expected castling rights");
+    }
+  }
+  // A right whose king or rook has left home can never be used; drop it so
+  // the state holds only rights the move generator can honor.
+  const int kRookIndex = MoveEngine::PieceToInt(kRook);
+  uint64_t white_rooks = (whites[kRookIndex] & Bitboard(0x81)).board_;
+  uint64_t black_rooks =
+      (blacks[kRookIndex] & Bitboard(0x8100000000000000)).board_;
+  if (whites[kKingIndex] != Bitboard(uint64_t{1} << 4)) {
+    white_rooks = 0;
+  }
+  if (blacks[kKingIndex] != Bitboard(uint64_t{1} << 60)) {
+    black_rooks = 0;
+  }
+  castling &= white_rooks | black_rooks;
 
-  int file_weight;
-  if (token[0] <= 'z' && token[0] >= 'a') {
-    file_weight = static_cast<int>(token[0]) - static_cast<int>('a');
+  if (!cursor.SkipSpaces()) {
+    return Fail(error, cursor.Column(),
+                "expected a space after the castling rights");
+  }
+  // FEN names the square behind the pawn that just moved two squares; the
+  // engine tracks the pawn itself, one rank further from its home.
+  uint64_t en_passant = 0;
+  if (cursor.Peek() == '-') {
+    cursor.Next();
   } else {
-    file_weight = static_cast<int>(token[0]) - static_cast<int>('A');
+    size_t column = cursor.Column();
+    char file = cursor.Next();
+    char rank = cursor.Next();
+    if (file < 'a' || file > 'h' || (rank != '3' && rank != '6')) {
+      return Fail(error, column, "expected an en passant square or -");
+    }
+
+    // The side that just moved must have a pawn in front of the square,
+    // with the square itself and the one the pawn left empty.
+    const int kPawnIndex = MoveEngine::PieceToInt(kPawn);
+    bool white_moved = color_at_play == kBlack;
+    int behind = 8 * (rank - '1') + (file - 'a');
+    int pawn = white_moved ? behind + 8 : behind - 8;
+    int start = white_moved ? behind - 8 : behind + 8;
+    const PieceBoards& movers = white_moved ? whites : blacks;
+    Bitboard occupied(0);
+    for (int i = 0; i < kNumberOfPieces; i++) {
+      occupied |= whites[i] | blacks[i];
+    }
+    Bitboard empty_squares =
+        Bitboard((uint64_t{1} << behind) | (uint64_t{1} << start));
+    if (rank != (white_moved ? '3' : '6') ||
+        (movers[kPawnIndex] & Bitboard(uint64_t{1} << pawn)) == Bitboard(0) ||
+        (occupied & empty_squares) != Bitboard(0)) {
+      return Fail(error, column,
+                  "no pawn just moved two squares past the en passant square");
+    }
+    en_passant = uint64_t{1} << pawn;
   }
-  int rank_weight = 8 * (static_cast<int>(token[1]) - 1 - 48);
 
-  return Bitboard().FromIndex(rank_weight + file_weight);
-}
+  half_moves_ = 0;
+  full_moves_ = 1;
+  bool spaced = cursor.SkipSpaces();
+  if (spaced && !cursor.AtEnd()) {
+    if (!cursor.ReadNumber(half_moves_)) {
+      return Fail(error, cursor.Column(),
+                  "expected a halfmove clock from 0 to 9999");
+    }
+    spaced = cursor.SkipSpaces();
+    if (spaced && !cursor.AtEnd() && !cursor.ReadNumber(full_moves_)) {
+      return Fail(error, cursor.Column(),
+                  "expected a move number from 0 to 9999");
+    }
+    cursor.SkipSpaces();
+  }
+  if (!cursor.AtEnd()) {
+    return Fail(error, cursor.Column(), "unexpected text after the FEN");
+  }
 
-short FenParser::ParseHalfMoves() {
-  std::string token = GetToken(kHalfTurns);
-  return static_cast<short>(stoi(token));
+  state = State(color_at_play, whites, blacks, Bitboard(en_passant),
+                Bitboard(castling));
+  return true;
 }
 
-short FenParser::ParseFullMoves() {
-  std::string token = GetToken(kFullTurns);
-  return static_cast<short>(stoi(token));
-}
+std::string FenParser::ToFen(const State& state, int half_moves,
+                             int full_moves) {
+  std::string fen;
 
-State FenParser::operator()(const std::string& fen_string) {
-  fen_string_ = fen_string;
+  for (int rank = 7; rank >= 0; rank--) {
+    int empty = 0;
+    for (int file = 0; file < 8; file++) {
+      Bitboard square(uint64_t{1} << (8 * rank + file));
+      char letter = '\0';
+      for (int i = 0; i < kNumberOfPieces; i++) {
+        if ((state.pieces_[i] & square) != Bitboard(0)) {
+          bool white = (state.all_whites_ & square) != Bitboard(0);
+          letter = white ? kPieceLetters[i] - 'a' + 'A' : kPieceLetters[i];
+        }
+      }
 
-  std::vector<Bitboard> white_bitboards(6);
-  std::vector<Bitboard> black_bitboards(6);
-  ParseBoard(white_bitboards, black_bitboards);
+      if (letter == '\0') {
+        empty++;
+        continue;
+      }
+      if (empty > 0) {
+        fen += static_cast<char>('0' + empty);
+        empty = 0;
+      }
+      fen += letter;
+    }
 
-  Bitboard all_whites = MoveEngine::AllBitboardsInOneBoard(white_bitboards);
-  Bitboard all_blacks = MoveEngine::AllBitboardsInOneBoard(black_bitboards);
+    if (empty > 0) {
+      fen += static_cast<char>('0' + empty);
+    }
+    if (rank > 0) {
+      fen += '/';
+    }
+  }
 
-  Color color_at_play = ParseColorAtPlay();
-  Bitboard enpassant = ParseEnPassant();
-  Bitboard castling = ParseCastling();
+  fen += state.color_at_play_ == kWhite ? " w " : " b ";
 
-  return State(color_at_play, all_whites, all_blacks, white_bitboards,
-               black_bitboards, enpassant, castling);
-}
+  const char kRights[] = "KQkq";
+  const int kRookSquares[] = {7, 0, 63, 56};
+  size_t rights_start = fen.size();
+  for (int i = 0; i < 4; i++) {
+    if ((state.castling_squares_ &
+         Bitboard(uint64_t{1} << kRookSquares[i])) != Bitboard(0)) {
+      fen += kRights[i];
+    }
+  }
+  if (fen.size() == rights_start) {
+    fen += '-';
+  }
 
-short FenParser::HalfMoves(const std::string& fen_string) {
-  fen_string_ = fen_string;
-  return ParseHalfMoves();
-}
+  if (state.en_passant_squares_ == Bitboard(0)) {
+    fen += " -";
+  } else {
+    int pawn = state.en_passant_squares_.Lsb();
+    int behind = pawn / 8 == 3 ? pawn - 8 : pawn + 8;
+    fen += ' ';
+    fen += static_cast<char>('a' + behind % 8);
+    fen += static_cast<char>('1' + behind / 8);
+  }
 
-short FenParser::FullMoves(const std::string& fen_string) {
-  fen_string_ = fen_string;
-  return ParseFullMoves();
+  return fen + " " + std::to_string(half_moves) + " " +
+         std::to_string(full_moves);
 }
 
 }  // namespace ChessEngine
@@ -9,10 +9,7 @@
 #ifndef CHESS_AI_FEN_PARSER_H_
 #define CHESS_AI_FEN_PARSER_H_
 
-#include <algorithm>
-#include <iostream>
-#include <map>
-#include <regex>
+#include <cstddef>
 #include <string>
 
 #include "chess-engine.h"
@@ -20,35 +17,37 @@
 
 namespace ChessEngine {
 
-enum FenToken {
-  kBoard,
-  kColorAtPlay,
-  kCastling,
-  kEnPassant,
-  kHalfTurns,
-  kFullTurns
+// What is wrong with a FEN and the column, from 0, where it goes wrong.
+struct FenError {
+  size_t column;
+  const char* message;
 };
 
+// Reads Forsyth-Edwards Notation in one pass over the string, straight into
+// the boards of a State. The two move counters may be left off, as in EPD,
+// and default to 0 and 1. An en passant square needs the pawn that just
+// passed it, and castling rights whose king or rook is not at home are
+// dropped, so a parsed State never holds a move the board cannot make.
 class FenParser {
  public:
+  // Throws std::logic_error naming the problem and its column.
   State operator()(const std::string& fen_string);
 
-  short HalfMoves(const std::string& fen_string);
-  short FullMoves(const std::string& fen_string);
+  // Fills state without throwing; on failure state is unspecified and
+  // error says why.
+  bool Parse(const std::string& fen_string, State& state, FenError& error);
 
- private:
-  std::string fen_string_;
-
-  std::string GetToken(FenToken token);
+  // Counters of the FEN last parsed.
+  short HalfMoves() const { return half_moves_; }
+  short FullMoves() const { return full_moves_; }
 
-  void ParseBoard(std::vector<Bitboard>& white_bitboard,
-                  std::vector<Bitboard>& black_bitboard);
-  Color ParseColorAtPlay();
-  Bitboard ParseCastling();
-  Bitboard ParseEnPassant();
+  // The FEN of state, for the given counters. Parsing it gives state back.
+  static std::string ToFen(const State& state, int half_moves = 0,
+                           int full_moves = 1);
 
-  short ParseHalfMoves();
-  short ParseFullMoves();
+ private:
+  short half_moves_ = 0;
+  short full_moves_ = 1;
 };
 
 }  // namespace ChessEngine
@@ -6,18 +6,58 @@
 //  Copyright 2018. Illya Starikov. All rights reserved.
 //
 
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
 #include <string>
+#include <thread>
 
+#include "batch.h"
+#include "bench.h"
 #include "chess-ai.h"
+#include "perft.h"
+#include "uci.h"
 
 void PrintUsage(const char* program_name) {
   std::cout << "Usage: " << program_name << " [OPTIONS] [FEN string]\n";
   std::cout << "If no FEN string is provided, uses the standard starting "
                "position.\n";
   std::cout << "\nOptions:\n";
-  std::cout << "  --worst    Enable worst mode (AI picks worst moves)\n";
-  std::cout << "  -h, --help Show this help message\n";
+  std::cout << "  --worst        Enable worst mode (AI picks worst moves)\n";
+  std::cout << "  --hash-mb <n>  Transposition table size in megabytes "
+               "(default 16)\n";
+  std::cout << "  --threads <n>  Search threads per move (default 1)\n";
+  std::cout << "  --search <s>   pvs (default) or minimax, the original "
+               "alpha-beta search\n";
+  std::cout << "  --clock-nodes <n>  Nodes searched between clock reads "
+               "(default 1024)\n";
+  std::cout << "  --nnue <file>  Evaluate with the neural network in file "
+               "instead of the handcrafted evaluation\n";
+  std::cout << "  --book <file>  Play from the Polyglot opening book in file "
+               "while it knows the position\n";
+  std::cout << "  --syzygy <dir> Probe the Syzygy tablebases in dir, "
+               "':'-separated (make SYZYGY=1)\n";
+  std::cout << "  --batch <file> Analyze every EPD or FEN line of file ('-' "
+               "for stdin), one JSON line each\n";
+  std::cout << "  --movetime <ms>  Search time per batch position "
+               "(default 1000)\n";
+  std::cout << "  --depth <d>    Search depth limit per batch position\n";
+  std::cout << "  --workers <n>  Positions searched at once in batch mode "
+               "(default: all cores)\n";
+  std::cout << "  --uci          Run as a UCI engine on stdin/stdout\n";
+  std::cout << "  --perft <d>    Count legal move paths to depth d, for the FEN "
+               "or the built-in suite\n";
+  std::cout << "  --divide <d>   Perft split by root move, for the FEN or the "
+               "start position\n";
+  std::cout << "  --bench <d>    Search the built-in benchmark positions to "
+               "depth d and print nodes per second\n";
+  std::cout << "  --compare <file>  Fail the bench if nodes per second fell "
+               "below the saved baseline\n";
+  std::cout << "  --max-regression <pct>  Slowdown --compare tolerates "
+               "(default 5)\n";
+  std::cout << "  --save-bench <file>  Save the bench summary as a baseline\n";
+  std::cout << "  -h, --help     Show this help message\n";
   std::cout << "\nExample:\n";
   std::cout << "  " << program_name << "\n";
   std::cout << "  " << program_name << " --worst\n";
@@ -29,9 +69,27 @@ void PrintUsage(const char* program_name) {
 
 int main(int argc, char* argv[]) {
   // Default to standard starting position.
-  std::string fen_string =
-      "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+  std::string fen_string = ChessEngine::kStartingFen;
   bool worst_mode = false;
+  bool uci_mode = false;
+  bool fen_given = false;
+  int perft_depth = 0;
+  int divide_depth = 0;
+  int threads = 1;
+  int clock_nodes = 0;
+  std::string network_file;
+  std::string book_file;
+  std::string tablebase_path;
+  std::string batch_file;
+  double batch_time = 1.0;
+  int batch_depth = ChessEngine::kMaxSearchDepth;
+  int workers = 0;
+  int bench_depth = 0;
+  std::string bench_baseline;
+  std::string bench_save;
+  double max_regression = 5;
+  ChessEngine::SearchAlgorithm search = ChessEngine::kPrincipalVariationSearch;
+  size_t hash_megabytes = ChessEngine::TranspositionTable::kDefaultMegabytes;
 
   // Parse command line arguments.
   for (int i = 1; i < argc; ++i) {
@@ -41,14 +99,195 @@ int main(int argc, char* argv[]) {
       return 0;
     } else if (arg == "--worst") {
       worst_mode = true;
+    } else if (arg == "--uci") {
+      uci_mode = true;
+    } else if (arg == "--perft" || arg == "--divide") {
+      if (i + 1 >= argc || std::atoi(argv[i + 1]) <= 0) {
+        std::cerr << arg << " expects a positive depth\n";
+        return 1;
+      }
+      (arg == "--perft" ? perft_depth : divide_depth) = std::atoi(argv[++i]);
+    } else if (arg == "--hash-mb") {
+      if (i + 1 >= argc || std::atoi(argv[i + 1]) <= 0) {
+        std::cerr << "--hash-mb expects a positive size in megabytes\n";
+        return 1;
+      }
+      hash_megabytes = std::strtoul(argv[++i], nullptr, 10);
+    } else if (arg == "--threads") {
+      if (i + 1 >= argc || std::atoi(argv[i + 1]) <= 0) {
+        std::cerr << "--threads expects a positive thread count\n";
+        return 1;
+      }
+      threads = std::atoi(argv[++i]);
+    } else if (arg == "--clock-nodes") {
+      if (i + 1 >= argc || std::atoi(argv[i + 1]) <= 0) {
+        std::cerr << "--clock-nodes expects a positive node count\n";
+        return 1;
+      }
+      clock_nodes = std::atoi(argv[++i]);
+    } else if (arg == "--nnue") {
+      if (i + 1 >= argc) {
+        std::cerr << "--nnue expects a network file\n";
+        return 1;
+      }
+      network_file = argv[++i];
+    } else if (arg == "--book") {
+      if (i + 1 >= argc) {
+        std::cerr << "--book expects a Polyglot book file\n";
+        return 1;
+      }
+      book_file = argv[++i];
+    } else if (arg == "--syzygy") {
+      if (i + 1 >= argc) {
+        std::cerr << "--syzygy expects a tablebase directory\n";
+        return 1;
+      }
+      tablebase_path = argv[++i];
+    } else if (arg == "--batch") {
+      if (i + 1 >= argc) {
+        std::cerr << "--batch expects an EPD file\n";
+        return 1;
+      }
+      batch_file = argv[++i];
+    } else if (arg == "--movetime") {
+      if (i + 1 >= argc || std::atoi(argv[i + 1]) <= 0) {
+        std::cerr << "--movetime expects a positive time in milliseconds\n";
+        return 1;
+      }
+      batch_time = std::atoi(argv[++i]) / 1000.0;
+    } else if (arg == "--depth") {
+      if (i + 1 >= argc || std::atoi(argv[i + 1]) <= 0) {
+        std::cerr << "--depth expects a positive depth\n";
+        return 1;
+      }
+      batch_depth = std::min(std::atoi(argv[++i]), batch_depth);
+    } else if (arg == "--workers") {
+      if (i + 1 >= argc || std::atoi(argv[i + 1]) <= 0) {
+        std::cerr << "--workers expects a positive worker count\n";
+        return 1;
+      }
+      workers = std::atoi(argv[++i]);
+    } else if (arg == "--bench") {
+      if (i + 1 >= argc || std::atoi(argv[i + 1]) <= 0) {
+        std::cerr << "--bench expects a positive depth\n";
+        return 1;
+      }
+      bench_depth =
+          std::min(std::atoi(argv[++i]), ChessEngine::kMaxSearchDepth);
+    } else if (arg == "--compare" || arg == "--save-bench") {
+      if (i + 1 >= argc) {
+        std::cerr << arg << " expects a file\n";
+        return 1;
+      }
+      (arg == "--compare" ? bench_baseline : bench_save) = argv[++i];
+    } else if (arg == "--max-regression") {
+      if (i + 1 >= argc || std::atof(argv[i + 1]) < 0) {
+        std::cerr << "--max-regression expects a percentage\n";
+        return 1;
+      }
+      max_regression = std::atof(argv[++i]);
+    } else if (arg == "--search") {
+      std::string name = i + 1 < argc ? argv[i + 1] : "";
+      if (name != "pvs" && name != "minimax") {
+        std::cerr << "--search expects pvs or minimax\n";
+        return 1;
+      }
+      search = name == "pvs" ? ChessEngine::kPrincipalVariationSearch
+                             : ChessEngine::kMinimaxSearch;
+      i++;
     } else {
       // Assume it's a FEN string.
       fen_string = arg;
+      fen_given = true;
     }
   }
 
+#ifdef DEBUG
+  if (!ChessEngine::MoveEngine::VerifySlidingAttacks()) {
+    std::cerr << "Sliding attack tables disagree with the ray reference\n";
+    return 1;
+  }
+#endif
+
   // Set worst mode if enabled.
   ChessEngine::ChessAI::SetWorstMode(worst_mode);
+  ChessEngine::ChessAI::SetThreads(threads);
+  ChessEngine::ChessAI::SetSearchAlgorithm(search);
+  if (clock_nodes > 0) {
+    ChessEngine::ChessAI::SetClockCheckInterval(clock_nodes);
+  }
+  if (!network_file.empty()) {
+    std::string error;
+    if (!ChessEngine::ChessAI::LoadNetwork(network_file, error)) {
+      std::cerr << "--nnue: " << error << "\n";
+      return 1;
+    }
+  }
+  if (!book_file.empty()) {
+    std::string error;
+    if (!ChessEngine::ChessAI::OpenBook(book_file, error)) {
+      std::cerr << "--book: " << error << "\n";
+      return 1;
+    }
+  }
+  if (!tablebase_path.empty()) {
+    std::string error;
+    if (!ChessEngine::Tablebases::Init(tablebase_path, error)) {
+      std::cerr << "--syzygy: " << error << "\n";
+      return 1;
+    }
+  }
+  if (hash_megabytes != ChessEngine::TranspositionTable::kDefaultMegabytes) {
+    ChessEngine::ChessAI::SetHashSize(hash_megabytes);
+  }
+
+  if (bench_depth > 0) {
+    return ChessEngine::Bench::Run(bench_depth, std::cout, bench_baseline,
+                                   max_regression / 100, bench_save)
+               ? 0
+               : 1;
+  }
+
+  if (perft_depth > 0 && !fen_given) {
+    return ChessEngine::Perft::RunSuite(perft_depth, std::cout) ? 0 : 1;
+  } else if (perft_depth > 0 || divide_depth > 0) {
+    ChessEngine::FenParser parser;
+    ChessEngine::State state = parser(fen_string);
+
+    if (divide_depth > 0) {
+      ChessEngine::Perft::Divide(state, divide_depth, std::cout);
+    } else {
+      std::cout << ChessEngine::Perft::Count(state, perft_depth) << "\n";
+    }
+    return 0;
+  }
+
+  if (!batch_file.empty()) {
+    // Each worker searches with --threads threads of its own.
+    if (workers == 0) {
+      int cores = static_cast<int>(std::thread::hardware_concurrency());
+      workers = std::max(1, cores / threads);
+    }
+
+    std::ifstream file;
+    if (batch_file != "-") {
+      file.open(batch_file);
+      if (!file) {
+        std::cerr << "--batch: cannot open " << batch_file << "\n";
+        return 1;
+      }
+    }
+    std::istream& input = batch_file == "-" ? std::cin : file;
+    return ChessEngine::Batch::Run(input, std::cout, batch_time, batch_depth,
+                                   workers)
+               ? 0
+               : 1;
+  }
+
+  if (uci_mode) {
+    ChessEngine::UciProtocol(std::cin, std::cout).Loop();
+    return 0;
+  }
 
   std::cout << "Chess AI - Minimax with Alpha-Beta Pruning\n";
   if (worst_mode) {
@@ -68,6 +307,8 @@ int main(int argc, char* argv[]) {
   ai.UpdateTimer(60.0);
 
   std::cout << "Computing best move...\n";
+  ai.SetStatsOutput(
+      [](const std::string& line) { std::cout << line << "\n"; });
 
   // Get best move from the AI.
   ChessEngine::Action best_move = ai.Move();
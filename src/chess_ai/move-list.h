@@ -0,0 +1,52 @@
+//
+//  move-list.h
+//  chess_ai
+//
+//  Created by Illya Starikov on 10/14/26.
+//  Copyright 2026. Illya Starikov. All rights reserved.
+//
+
+#ifndef CHESS_AI_MOVE_LIST_H_
+#define CHESS_AI_MOVE_LIST_H_
+
+#include <array>
+#include <cstddef>
+
+#include "action.h"
+
+namespace ChessEngine {
+
+// Which moves a generator call produces. Noisy moves are captures, en
+// passant and promotions; quiet moves are everything else, castling
+// included. Searching the noisy stage first lets a cutoff skip generating
+// the quiet moves at all.
+enum MoveStage { kNoisyMoves, kQuietMoves, kAllMoves };
+
+// Fixed-capacity list of actions that never allocates. No legal chess
+// position has more than 218 moves.
+class MoveList {
+ public:
+  static const size_t kCapacity = 256;
+
+  void Add(const Action& action) { actions_[size_++] = action; }
+  void Clear() { size_ = 0; }
+
+  size_t Size() const { return size_; }
+  bool Empty() const { return size_ == 0; }
+
+  Action& operator[](size_t index) { return actions_[index]; }
+  const Action& operator[](size_t index) const { return actions_[index]; }
+
+  Action* begin() { return actions_.data(); }
+  Action* end() { return actions_.data() + size_; }
+  const Action* begin() const { return actions_.data(); }
+  const Action* end() const { return actions_.data() + size_; }
+
+ private:
+  std::array<Action, kCapacity> actions_;
+  size_t size_ = 0;
+};
+
+}  // namespace ChessEngine
+
+#endif  // CHESS_AI_MOVE_LIST_H_
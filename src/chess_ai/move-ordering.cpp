@@ -0,0 +1,265 @@
+//
+//  move-ordering.cpp
+//  chess_ai
+//
+//  Created by Illya Starikov on 10/14/26.
+//  Copyright 2026. Illya Starikov. All rights reserved.
+//
+
+#include "move-ordering.h"
+
+#include <utility>
+
+#include "chess-ai.h"
+
+namespace ChessEngine {
+
+void MoveHistory::Clear() {
+  for (auto& from_squares : history_) {
+    for (auto& to_squares : from_squares) {
+      for (int& score : to_squares) {
+        score = 0;
+      }
+    }
+  }
+
+  for (auto& killers : killers_) {
+    killers[0] = killers[1] = Action(0);
+  }
+}
+
+void MoveHistory::AddCutoff(const Action& action, int ply, int depth) {
+  if (ply < kMaxPly && !(killers_[ply][0] == action)) {
+    killers_[ply][1] = killers_[ply][0];
+    killers_[ply][0] = action;
+  }
+
+  int& score = history_[action.GetColor()][action.From()][action.To()];
+  score += depth * depth;
+
+  if (score > kHistoryLimit) {
+    for (auto& from_squares : history_) {
+      for (auto& to_squares : from_squares) {
+        for (int& entry : to_squares) {
+          entry /= 2;
+        }
+      }
+    }
+  }
+}
+
+MovePicker::MovePicker(const State& state, const MoveHistory& history,
+                       int ply, const Action& table_move,
+                       MovePickerBuffers& buffers)
+    : state_(state),
+      history_(&history),
+      ply_(ply),
+      table_move_(table_move),
+      table_move_found_(false),
+      noisy_only_(false),
+      phase_(kTableMovePhase),
+      noisy_(buffers.noisy),
+      noisy_scores_(buffers.noisy_scores),
+      noisy_index_(0),
+      noisy_generated_(false),
+      quiet_(buffers.quiet),
+      quiet_scores_(buffers.quiet_scores),
+      quiet_index_(0),
+      quiet_generated_(false) {
+  noisy_.Clear();
+  quiet_.Clear();
+}
+
+MovePicker::MovePicker(const State& state, MovePickerBuffers& buffers)
+    : state_(state),
+      history_(nullptr),
+      ply_(0),
+      table_move_(0),
+      table_move_found_(false),
+      noisy_only_(true),
+      phase_(kGoodNoisyPhase),
+      noisy_(buffers.noisy),
+      noisy_scores_(buffers.noisy_scores),
+      noisy_index_(0),
+      noisy_generated_(false),
+      quiet_(buffers.quiet),
+      quiet_scores_(buffers.quiet_scores),
+      quiet_index_(0),
+      quiet_generated_(false) {
+  noisy_.Clear();
+  quiet_.Clear();
+}
+
+bool MovePicker::Next(Action& action) {
+  switch (phase_) {
+    case kTableMovePhase:
+      phase_ = kGoodNoisyPhase;
+      if (FindTableMove()) {
+        action = table_move_;
+        return true;
+      }
+      [[fallthrough]];
+
+    case kGoodNoisyPhase:
+      // Nothing has been picked yet on the first visit.
+      if (noisy_index_ == 0) {
+        GenerateNoisy();
+        ScoreNoisy();
+      }
+      if (PickBest(noisy_, noisy_scores_, noisy_index_, 0, action)) {
+        return true;
+      }
+      if (noisy_only_) {
+        phase_ = kDonePhase;
+        return false;
+      }
+      phase_ = kQuietPhase;
+      GenerateQuiet();
+      ScoreQuiet();
+      [[fallthrough]];
+
+    case kQuietPhase:
+      if (PickBest(quiet_, quiet_scores_, quiet_index_, kPickedScore + 1,
+                   action)) {
+        return true;
+      }
+      phase_ = kBadNoisyPhase;
+      [[fallthrough]];
+
+    case kBadNoisyPhase:
+      if (PickBest(noisy_, noisy_scores_, noisy_index_, kPickedScore + 1,
+                   action)) {
+        return true;
+      }
+      phase_ = kDonePhase;
+      [[fallthrough]];
+
+    case kDonePhase:
+      return false;
+  }
+
+  return false;
+}
+
+bool MovePicker::FindTableMove() {
+  if (table_move_.Key() == 0) {
+    return false;
+  }
+
+  MoveList* moves = &quiet_;
+  if (IsNoisy(table_move_)) {
+    GenerateNoisy();
+    moves = &noisy_;
+  } else {
+    GenerateQuiet();
+  }
+
+  for (const Action& action : *moves) {
+    if (action == table_move_) {
+      table_move_found_ = true;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void MovePicker::GenerateNoisy() {
+  if (!noisy_generated_) {
+    ChessAI::GenerateActions(state_, kNoisyMoves, noisy_);
+    noisy_generated_ = true;
+  }
+}
+
+void MovePicker::GenerateQuiet() {
+  if (!quiet_generated_) {
+    ChessAI::GenerateActions(state_, kQuietMoves, quiet_);
+    quiet_generated_ = true;
+  }
+}
+
+void MovePicker::ScoreNoisy() {
+  // Losing captures sort below every good one and are left for last, or
+  // dropped in quiescence.
+  const int kLosingCapture = -(1 << 24);
+
+  for (size_t i = 0; i < noisy_.Size(); i++) {
+    const Action& action = noisy_[i];
+
+    if (table_move_found_ && action == table_move_) {
+      noisy_scores_[i] = kPickedScore;
+    } else if (action.WasPromotion() || action.WasWinningCapture() ||
+               ChessAI::StaticExchange(state_, action) >= 0) {
+      noisy_scores_[i] = MvvLva(action);
+    } else if (noisy_only_) {
+      noisy_scores_[i] = kPickedScore;
+    } else {
+      noisy_scores_[i] = kLosingCapture + MvvLva(action);
+    }
+  }
+}
+
+void MovePicker::ScoreQuiet() {
+  const int kFirstKiller = 1 << 29;
+  const int kSecondKiller = kFirstKiller - 1;
+
+  bool has_killers = ply_ < MoveHistory::kMaxPly;
+
+  for (size_t i = 0; i < quiet_.Size(); i++) {
+    const Action& action = quiet_[i];
+
+    if (table_move_found_ && action == table_move_) {
+      quiet_scores_[i] = kPickedScore;
+    } else if (has_killers && action == history_->Killer(ply_, 0)) {
+      quiet_scores_[i] = kFirstKiller;
+    } else if (has_killers && action == history_->Killer(ply_, 1)) {
+      quiet_scores_[i] = kSecondKiller;
+    } else {
+      quiet_scores_[i] = history_->History(action);
+    }
+  }
+}
+
+bool MovePicker::PickBest(MoveList& moves, int* scores, size_t& index,
+                          int min_score, Action& action) {
+  if (index >= moves.Size()) {
+    return false;
+  }
+
+  size_t best = index;
+  for (size_t i = index + 1; i < moves.Size(); i++) {
+    if (scores[i] > scores[best]) {
+      best = i;
+    }
+  }
+
+  if (scores[best] < min_score) {
+    return false;
+  }
+
+  std::swap(moves[index], moves[best]);
+  std::swap(scores[index], scores[best]);
+  action = moves[index++];
+  return true;
+}
+
+int MovePicker::MvvLva(const Action& action) {
+  // Indexed by Piece: king, queen, rook, bishop, knight, pawn.
+  const int kAttackerRank[kNumberOfPieces] = {5, 4, 3, 2, 1, 0};
+
+  int victim = 0;
+  if (action.WasCapture()) {
+    victim = kPieceValues[action.PieceCaptured()];
+  } else if (action.WasEnPassantCapture()) {
+    victim = kPieceValues[kPawn];
+  }
+  if (action.WasPromotion()) {
+    victim += kPieceValues[action.PromotedTo()] - kPieceValues[kPawn];
+  }
+
+  // Victim values are centipawns, a pawn or more apart when they differ,
+  // so the attacker rank (0 to 5) only breaks ties.
+  return 8 * victim - kAttackerRank[action.GetPiece()];
+}
+
+}  // namespace ChessEngine
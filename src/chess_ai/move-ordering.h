@@ -0,0 +1,138 @@
+//
+//  move-ordering.h
+//  chess_ai
+//
+//  Created by Illya Starikov on 10/14/26.
+//  Copyright 2026. Illya Starikov. All rights reserved.
+//
+
+#ifndef CHESS_AI_MOVE_ORDERING_H_
+#define CHESS_AI_MOVE_ORDERING_H_
+
+#include <cstddef>
+
+#include "action.h"
+#include "constants.h"
+#include "move-list.h"
+#include "state.h"
+
+namespace ChessEngine {
+
+// What one search thread has learned about quiet moves: the two moves that
+// last caused a cutoff at each ply (killers), and a score per color, from
+// square and to square that grows with every cutoff (history).
+class MoveHistory {
+ public:
+  MoveHistory() { Clear(); }
+
+  void Clear();
+
+  // Credits a quiet action that caused a cutoff at ply with depth left.
+  void AddCutoff(const Action& action, int ply, int depth);
+
+  int History(const Action& action) const {
+    return history_[action.GetColor()][action.From()][action.To()];
+  }
+
+  // Slot 0 holds the most recent killer at the ply.
+  const Action& Killer(int ply, int slot) const { return killers_[ply][slot]; }
+
+  static const int kMaxPly = kMaxSearchDepth;
+
+ private:
+  // History scores are halved once one passes this, so recent cutoffs
+  // keep outweighing old ones.
+  static const int kHistoryLimit = 1 << 20;
+
+  int history_[2][64][64];
+  Action killers_[kMaxPly][2];
+};
+
+// The move lists and scores one MovePicker works in. Search threads keep
+// one per ply, made once, so a node's picker neither allocates nor needs a
+// large stack frame.
+struct MovePickerBuffers {
+  MoveList noisy;
+  int noisy_scores[MoveList::kCapacity];
+  MoveList quiet;
+  int quiet_scores[MoveList::kCapacity];
+};
+
+// Hands out the legal actions of a position one at a time, best first: the
+// transposition table move, captures and promotions that do not lose
+// material (most valuable victim first), the killers, the other quiet moves
+// by history, and last the losing captures. Quiet moves are only generated
+// once the good captures are used up, and every pick is a selection over
+// the actions left rather than a full sort.
+class MovePicker {
+ public:
+  // For search nodes. The table move may be any action, or Action(0) for
+  // none; it is only returned if it is legal in the state. The picker
+  // works in buffers, which no other live picker may share.
+  MovePicker(const State& state, const MoveHistory& history, int ply,
+             const Action& table_move, MovePickerBuffers& buffers);
+
+  // For quiescence nodes: only captures and promotions that do not lose
+  // material.
+  MovePicker(const State& state, MovePickerBuffers& buffers);
+
+  MovePicker(const MovePicker& other) = delete;
+  MovePicker& operator=(const MovePicker& other) = delete;
+
+  // Sets action to the next best action. False once none are left.
+  bool Next(Action& action);
+
+  static bool IsNoisy(const Action& action) {
+    return action.WasCapture() || action.WasEnPassantCapture() ||
+           action.WasPromotion();
+  }
+
+ private:
+  enum Phase {
+    kTableMovePhase,
+    kGoodNoisyPhase,
+    kQuietPhase,
+    kBadNoisyPhase,
+    kDonePhase
+  };
+
+  // Score of the table move once returned, so it is never picked again.
+  static const int kPickedScore = -(1 << 30);
+
+  const State& state_;
+  const MoveHistory* history_;  // nullptr in quiescence
+  int ply_;
+
+  Action table_move_;
+  bool table_move_found_;
+  bool noisy_only_;
+  Phase phase_;
+
+  MoveList& noisy_;
+  int* noisy_scores_;
+  size_t noisy_index_;
+  bool noisy_generated_;
+
+  MoveList& quiet_;
+  int* quiet_scores_;
+  size_t quiet_index_;
+  bool quiet_generated_;
+
+  bool FindTableMove();
+  void GenerateNoisy();
+  void GenerateQuiet();
+  void ScoreNoisy();
+  void ScoreQuiet();
+
+  // Moves the best scored action at or after index to index and returns
+  // it, unless no action left scores at least min_score.
+  static bool PickBest(MoveList& moves, int* scores, size_t& index,
+                       int min_score, Action& action);
+
+  // Most valuable victim first, least valuable attacker among equals.
+  static int MvvLva(const Action& action);
+};
+
+}  // namespace ChessEngine
+
+#endif  // CHESS_AI_MOVE_ORDERING_H_
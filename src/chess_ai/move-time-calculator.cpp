@@ -8,6 +8,8 @@
 
 #include "move-time-calculator.h"
 
+#include <algorithm>
+
 namespace ChessEngine {
 
 double MoveTimeCalculator::operator()(int move_number, double time_remaining) {
@@ -19,4 +21,100 @@ double MoveTimeCalculator::operator()(int move_number, double time_remaining) {
          (0.1 + std::exp(-std::pow(move_number - kB, 2) / (2 * kC * kC)));
 }
 
+void MoveTimeCalculator::Plan(int move_number, double time_remaining,
+                              double increment, int moves_to_go) {
+  // Kept back for the protocol and the process to hand the move over.
+  const double kMoveOverhead = 0.05;
+  const double kMinimumTime = 0.01;
+  // Most of the increment comes back with the move, so it is safe to spend.
+  const double kIncrementShare = 0.75;
+  const double kHardToSoft = 4.0;
+  const double kMaximumShare = 0.5;
+
+  double available = std::max(time_remaining - kMoveOverhead, kMinimumTime);
+
+  double soft;
+  if (moves_to_go > 0) {
+    soft = available / (moves_to_go + 1);
+  } else {
+    soft = (*this)(move_number, available);
+  }
+  soft += kIncrementShare * increment;
+
+  hard_limit_ = std::min(kHardToSoft * soft, kMaximumShare * available);
+  hard_limit_ = std::max(hard_limit_, kMinimumTime);
+  soft_limit_ = std::min(soft, hard_limit_);
+  adjustable_ = true;
+
+  ResetIterations();
+}
+
+void MoveTimeCalculator::PlanFixed(double move_time) {
+  soft_limit_ = hard_limit_ = move_time;
+  adjustable_ = false;
+
+  ResetIterations();
+}
+
+void MoveTimeCalculator::CompleteIteration(const Action& best_move,
+                                           float value,
+                                           double iteration_time) {
+  if (iterations_ > 0 && best_move == best_move_) {
+    stable_iterations_++;
+  } else {
+    stable_iterations_ = 0;
+  }
+
+  // Mate scores are infinite; a drop only counts between real scores.
+  value_drop_ = 0;
+  if (iterations_ > 0 && std::isfinite(value) && std::isfinite(value_)) {
+    value_drop_ = std::max(value_ - value, 0.0f);
+  }
+
+  iterations_++;
+  best_move_ = best_move;
+  value_ = value;
+  previous_iteration_time_ = iteration_time_;
+  iteration_time_ = iteration_time;
+}
+
+bool MoveTimeCalculator::StartIteration(double elapsed) const {
+  // Iterations grow by at least this much; trees are rarely narrower.
+  const double kMinimumGrowth = 1.5;
+  const double kMaximumGrowth = 6.0;
+
+  double soft_limit = soft_limit_;
+  if (adjustable_) {
+    // A best move that just changed earns a little more time, one that has
+    // held for several iterations down to half. Losing a pawn's worth of
+    // score since the last iteration doubles it.
+    double stability = std::max(0.5, 1.2 - 0.1 * stable_iterations_);
+    double drop = 1.0 + std::min(static_cast<double>(value_drop_), 1.0);
+    soft_limit = std::min(soft_limit * stability * drop, hard_limit_);
+  }
+
+  if (elapsed >= soft_limit) {
+    return false;
+  }
+
+  double growth = kMaximumGrowth;
+  if (previous_iteration_time_ > 0) {
+    growth = std::clamp(iteration_time_ / previous_iteration_time_,
+                        kMinimumGrowth, kMaximumGrowth);
+  }
+
+  // An iteration cut off at the hard limit is thrown away.
+  return elapsed + iteration_time_ * growth <= hard_limit_;
+}
+
+void MoveTimeCalculator::ResetIterations() {
+  iterations_ = 0;
+  stable_iterations_ = 0;
+  best_move_ = Action(0);
+  value_ = 0;
+  value_drop_ = 0;
+  iteration_time_ = 0;
+  previous_iteration_time_ = 0;
+}
+
 }  // namespace ChessEngine
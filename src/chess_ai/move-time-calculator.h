@@ -11,11 +11,52 @@
 
 #include <cmath>
 
+#include "action.h"
+
 namespace ChessEngine {
 
+// Decides how long one move may take. A search never runs past the hard
+// limit; past the soft limit it only finishes the iteration it is on. The
+// soft limit shrinks while the best move holds from one iteration to the
+// next and grows when it changes or the score drops.
 class MoveTimeCalculator {
  public:
+  // The share of time_remaining a sudden death game spends on a move,
+  // most of it in the middlegame.
   double operator()(int move_number, double time_remaining);
+
+  // Plans a move on the clock. Increment is added after every move, and
+  // moves_to_go is the number of moves until the next time control, or 0
+  // if the rest of the game must fit in time_remaining.
+  void Plan(int move_number, double time_remaining, double increment,
+            int moves_to_go);
+  // Plans a move of exactly move_time seconds, which may be infinite.
+  void PlanFixed(double move_time);
+
+  double HardLimit() const { return hard_limit_; }
+
+  // Called after every completed iteration with its result and duration.
+  void CompleteIteration(const Action& best_move, float value,
+                         double iteration_time);
+  // Whether another iteration is worth starting after elapsed seconds:
+  // the soft limit has not passed and, judging by how fast the last
+  // iterations grew, the next one can finish before the hard limit.
+  bool StartIteration(double elapsed) const;
+
+ private:
+  double soft_limit_ = 0;
+  double hard_limit_ = 0;
+  bool adjustable_ = false;
+
+  int iterations_ = 0;
+  int stable_iterations_ = 0;
+  Action best_move_ = Action(0);
+  float value_ = 0;
+  float value_drop_ = 0;
+  double iteration_time_ = 0;
+  double previous_iteration_time_ = 0;
+
+  void ResetIterations();
 };
 
 }  // namespace ChessEngine
@@ -0,0 +1,367 @@
+//
+//  nnue.cpp
+//  chess_ai
+//
+//  Created by Illya Starikov on 10/14/26.
+//  Copyright 2026. Illya Starikov. All rights reserved.
+//
+
+#include "nnue.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace ChessEngine {
+
+namespace {
+
+const char kMagic[8] = {'C', 'A', 'I', 'N', 'N', 'U', 'E', '1'};
+
+// Every piece on the board, at most 32 including kings.
+const int kMaxFeatures = 32;
+
+// Accumulators are updated a tile of this many values at a time, so the
+// tile stays in registers while every changed column is applied to it:
+// eight AVX2 registers or sixteen NEON ones.
+const int kTileSize = 128;
+
+static_assert(kNnueHiddenSize % kTileSize == 0,
+              "the hidden layer must split into whole tiles");
+
+int FeatureIndex(Color perspective, const NnueFeature& feature) {
+  // Black sees the board flipped, with its own pieces first.
+  int relative_color = feature.color == perspective ? 0 : 1;
+  int square = perspective == kWhite ? feature.square : feature.square ^ 56;
+
+  return (relative_color * kNumberOfPieces + feature.piece) * 64 + square;
+}
+
+// Sets out to base minus the removed columns plus the added ones.
+void ApplyColumns(const int16_t* base, const int16_t* const* removed,
+                  int removed_count, const int16_t* const* added,
+                  int added_count, int16_t* out) {
+#if defined(__AVX2__)
+  const int kRegisters = kTileSize / 16;
+
+  for (int tile = 0; tile < kNnueHiddenSize; tile += kTileSize) {
+    __m256i values[kRegisters];
+    for (int i = 0; i < kRegisters; i++) {
+      values[i] = _mm256_loadu_si256(
+          reinterpret_cast<const __m256i*>(base + tile + 16 * i));
+    }
+    for (int r = 0; r < removed_count; r++) {
+      for (int i = 0; i < kRegisters; i++) {
+        values[i] = _mm256_sub_epi16(
+            values[i], _mm256_loadu_si256(reinterpret_cast<const __m256i*>(
+                           removed[r] + tile + 16 * i)));
+      }
+    }
+    for (int a = 0; a < added_count; a++) {
+      for (int i = 0; i < kRegisters; i++) {
+        values[i] = _mm256_add_epi16(
+            values[i], _mm256_loadu_si256(reinterpret_cast<const __m256i*>(
+                           added[a] + tile + 16 * i)));
+      }
+    }
+    for (int i = 0; i < kRegisters; i++) {
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + tile + 16 * i),
+                          values[i]);
+    }
+  }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  const int kRegisters = kTileSize / 8;
+
+  for (int tile = 0; tile < kNnueHiddenSize; tile += kTileSize) {
+    int16x8_t values[kRegisters];
+    for (int i = 0; i < kRegisters; i++) {
+      values[i] = vld1q_s16(base + tile + 8 * i);
+    }
+    for (int r = 0; r < removed_count; r++) {
+      for (int i = 0; i < kRegisters; i++) {
+        values[i] = vsubq_s16(values[i], vld1q_s16(removed[r] + tile + 8 * i));
+      }
+    }
+    for (int a = 0; a < added_count; a++) {
+      for (int i = 0; i < kRegisters; i++) {
+        values[i] = vaddq_s16(values[i], vld1q_s16(added[a] + tile + 8 * i));
+      }
+    }
+    for (int i = 0; i < kRegisters; i++) {
+      vst1q_s16(out + tile + 8 * i, values[i]);
+    }
+  }
+#else
+  // Wraps like the vector instructions instead of overflowing.
+  for (int i = 0; i < kNnueHiddenSize; i++) {
+    int16_t value = base[i];
+    for (int r = 0; r < removed_count; r++) {
+      value = static_cast<int16_t>(value - removed[r][i]);
+    }
+    for (int a = 0; a < added_count; a++) {
+      value = static_cast<int16_t>(value + added[a][i]);
+    }
+    out[i] = value;
+  }
+#endif
+}
+
+// The hidden layer clipped to [0, kNnueActivationScale], weighed by the
+// int8 output weights.
+int32_t ClippedDot(const int16_t* hidden, const int8_t* weights) {
+#if defined(__AVX2__)
+  const __m256i kZero = _mm256_setzero_si256();
+  const __m256i kCeiling = _mm256_set1_epi16(kNnueActivationScale);
+  const __m256i kOnes = _mm256_set1_epi16(1);
+
+  __m256i sum = _mm256_setzero_si256();
+  for (int i = 0; i < kNnueHiddenSize; i += 32) {
+    __m256i low =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(hidden + i));
+    __m256i high =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(hidden + i + 16));
+    low = _mm256_min_epi16(_mm256_max_epi16(low, kZero), kCeiling);
+    high = _mm256_min_epi16(_mm256_max_epi16(high, kZero), kCeiling);
+
+    // Packing interleaves the 128-bit halves; the permute puts the 32
+    // activations back in order.
+    __m256i activations = _mm256_permute4x64_epi64(
+        _mm256_packus_epi16(low, high), 0xd8);
+    __m256i products = _mm256_maddubs_epi16(
+        activations,
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i)));
+    sum = _mm256_add_epi32(sum, _mm256_madd_epi16(products, kOnes));
+  }
+
+  __m128i halves = _mm_add_epi32(_mm256_castsi256_si128(sum),
+                                 _mm256_extracti128_si256(sum, 1));
+  halves = _mm_add_epi32(halves, _mm_shuffle_epi32(halves, 0x4e));
+  halves = _mm_add_epi32(halves, _mm_shuffle_epi32(halves, 0xb1));
+  return _mm_cvtsi128_si32(halves);
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  const int16x8_t kZero = vdupq_n_s16(0);
+  const int16x8_t kCeiling = vdupq_n_s16(kNnueActivationScale);
+
+  int32x4_t sum = vdupq_n_s32(0);
+  for (int i = 0; i < kNnueHiddenSize; i += 8) {
+    int16x8_t activations =
+        vminq_s16(vmaxq_s16(vld1q_s16(hidden + i), kZero), kCeiling);
+    int16x8_t weight = vmovl_s8(vld1_s8(weights + i));
+
+    sum = vmlal_s16(sum, vget_low_s16(activations), vget_low_s16(weight));
+    sum = vmlal_s16(sum, vget_high_s16(activations), vget_high_s16(weight));
+  }
+  return vaddvq_s32(sum);
+#else
+  int32_t sum = 0;
+  for (int i = 0; i < kNnueHiddenSize; i++) {
+    int activation =
+        std::clamp(static_cast<int>(hidden[i]), 0, kNnueActivationScale);
+    sum += activation * weights[i];
+  }
+  return sum;
+#endif
+}
+
+template <class T>
+bool ReadValues(std::ifstream& file, std::vector<T>& values, size_t count) {
+  values.resize(count);
+  file.read(reinterpret_cast<char*>(values.data()),
+            static_cast<std::streamsize>(count * sizeof(T)));
+  return static_cast<bool>(file);
+}
+
+}  // namespace
+
+bool NnueNetwork::Load(const std::string& path, std::string& error) {
+  loaded_ = false;
+
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    error = "cannot open " + path;
+    return false;
+  }
+
+  // Values are read as they are stored, which assumes a little-endian host
+  // like every x86-64 and AArch64 machine.
+  char magic[sizeof(kMagic)];
+  uint32_t hidden_size = 0;
+  file.read(magic, sizeof(magic));
+  file.read(reinterpret_cast<char*>(&hidden_size), sizeof(hidden_size));
+  if (!file || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0) {
+    error = path + " is not a network file";
+    return false;
+  }
+  if (hidden_size != static_cast<uint32_t>(kNnueHiddenSize)) {
+    error = path + " has " + std::to_string(hidden_size) +
+            " hidden units, expected " + std::to_string(kNnueHiddenSize);
+    return false;
+  }
+
+  bool complete =
+      ReadValues(file, weights_,
+                 static_cast<size_t>(kNnueInputSize) * kNnueHiddenSize) &&
+      ReadValues(file, biases_, kNnueHiddenSize) &&
+      ReadValues(file, output_weights_, 2 * kNnueHiddenSize);
+  file.read(reinterpret_cast<char*>(&output_bias_), sizeof(output_bias_));
+  if (!complete || !file) {
+    error = path + " is truncated";
+    return false;
+  }
+  if (file.peek() != std::ifstream::traits_type::eof()) {
+    error = path + " is longer than a network";
+    return false;
+  }
+
+  loaded_ = true;
+  return true;
+}
+
+void NnueNetwork::Refresh(const State& state,
+                          NnueAccumulator& accumulator) const {
+  NnueFeature features[kMaxFeatures];
+  int count = 0;
+
+  for (Color color : {kWhite, kBlack}) {
+    for (int i = 0; i < kNumberOfPieces; i++) {
+      Piece piece = MoveEngine::IntToPiece(i);
+      for (int square : state.Pieces(color, piece)) {
+        if (count < kMaxFeatures) {
+          features[count++] = {color, piece, square};
+        }
+      }
+    }
+  }
+
+  for (Color perspective : {kWhite, kBlack}) {
+    const int16_t* columns[kMaxFeatures];
+    for (int i = 0; i < count; i++) {
+      columns[i] = weights_.data() +
+                   FeatureIndex(perspective, features[i]) * kNnueHiddenSize;
+    }
+    ApplyColumns(biases_.data(), nullptr, 0, columns, count,
+                 accumulator.values[perspective]);
+  }
+}
+
+void NnueNetwork::Update(const NnueAccumulator& parent,
+                         const NnueFeature* removed, int removed_count,
+                         const NnueFeature* added, int added_count,
+                         NnueAccumulator& accumulator) const {
+  for (Color perspective : {kWhite, kBlack}) {
+    const int16_t* removed_columns[2];
+    const int16_t* added_columns[2];
+
+    for (int i = 0; i < removed_count; i++) {
+      removed_columns[i] =
+          weights_.data() +
+          FeatureIndex(perspective, removed[i]) * kNnueHiddenSize;
+    }
+    for (int i = 0; i < added_count; i++) {
+      added_columns[i] = weights_.data() +
+                         FeatureIndex(perspective, added[i]) * kNnueHiddenSize;
+    }
+
+    ApplyColumns(parent.values[perspective], removed_columns, removed_count,
+                 added_columns, added_count, accumulator.values[perspective]);
+  }
+}
+
+int NnueNetwork::Evaluate(const NnueAccumulator& accumulator,
+                          Color side_to_move) const {
+  Color other_side = static_cast<Color>((side_to_move + 1) % 2);
+
+  int64_t output =
+      static_cast<int64_t>(output_bias_) +
+      ClippedDot(accumulator.values[side_to_move], output_weights_.data()) +
+      ClippedDot(accumulator.values[other_side],
+                 output_weights_.data() + kNnueHiddenSize);
+
+  return static_cast<int>(output * kNnueOutputScale /
+                          (kNnueActivationScale * kNnueWeightScale));
+}
+
+void NnueAccumulatorStack::Reset(const NnueNetwork& network,
+                                 const State& state) {
+  top_ = 0;
+  enabled_ = network.Loaded();
+  if (!enabled_) {
+    return;
+  }
+
+  if (entries_.empty()) {
+    entries_.reserve(kMaxSearchPly + 1);
+    entries_.resize(1);
+  }
+  Entry& root = entries_[0];
+  root.removed_count = root.added_count = 0;
+  root.computed = true;
+  network.Refresh(state, root.accumulator);
+}
+
+NnueAccumulatorStack::Entry& NnueAccumulatorStack::PushEntry() {
+  top_++;
+  if (top_ == static_cast<int>(entries_.size())) {
+    entries_.emplace_back();
+  }
+
+  Entry& entry = entries_[top_];
+  entry.computed = false;
+  entry.removed_count = entry.added_count = 0;
+  return entry;
+}
+
+void NnueAccumulatorStack::Record(const State& state, const Action& action,
+                                  const Undo& undo) {
+  Entry& entry = PushEntry();
+
+  Color color = action.GetColor();
+  Color enemy_color = static_cast<Color>((color + 1) % 2);
+  Piece piece = action.GetPiece();
+  Piece moved_as = action.WasPromotion() ? action.PromotedTo() : piece;
+
+  entry.removed[entry.removed_count++] = {color, piece, action.From()};
+  entry.added[entry.added_count++] = {color, moved_as, action.To()};
+
+  if (action.WasCapture()) {
+    entry.removed[entry.removed_count++] = {enemy_color,
+                                            action.PieceCaptured(),
+                                            action.To()};
+  } else if (action.WasEnPassantCapture()) {
+    entry.removed[entry.removed_count++] = {enemy_color, kPawn,
+                                            undo.en_passant_squares.Lsb()};
+  } else if (action.QueenSideCastling() || action.KingSideCastling()) {
+    // Castling is encoded as the rook's move.
+    entry.removed[entry.removed_count++] = {color, kKing,
+                                            undo.king_before_castling.Lsb()};
+    entry.added[entry.added_count++] = {color, kKing,
+                                        state.Pieces(color, kKing).Lsb()};
+  }
+}
+
+const NnueAccumulator& NnueAccumulatorStack::Current(
+    const NnueNetwork& network) {
+  // The root is always computed, so the walk up stops there at the latest.
+  int computed = top_;
+  while (!entries_[computed].computed) {
+    computed--;
+  }
+
+  for (int i = computed + 1; i <= top_; i++) {
+    Entry& entry = entries_[i];
+    network.Update(entries_[i - 1].accumulator, entry.removed,
+                   entry.removed_count, entry.added, entry.added_count,
+                   entry.accumulator);
+    entry.computed = true;
+  }
+
+  return entries_[top_].accumulator;
+}
+
+}  // namespace ChessEngine
@@ -0,0 +1,141 @@
+//
+//  nnue.h
+//  chess_ai
+//
+//  Created by Illya Starikov on 10/14/26.
+//  Copyright 2026. Illya Starikov. All rights reserved.
+//
+
+#ifndef CHESS_AI_NNUE_H_
+#define CHESS_AI_NNUE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "action.h"
+#include "chess-pieces.h"
+#include "color.h"
+#include "constants.h"
+#include "state.h"
+
+namespace ChessEngine {
+
+// An efficiently updatable neural network evaluation. One input per color,
+// piece and square feeds a hidden layer of kNnueHiddenSize units, once as
+// seen by white and once, mirrored, as seen by black. The two hidden layers are
+// clipped to [0, 1], side to move first, and a single output unit weighs
+// them into a score. A move changes at most four inputs, so the hidden
+// layers (the accumulator) are updated by adding and subtracting a few
+// weight columns rather than recomputed.
+//
+// Weights are quantized: the first layer is int16 scaled by
+// kNnueActivationScale, the output layer int8 scaled by kNnueWeightScale.
+// The network file is little-endian:
+//   char[8]  "CAINNUE1"
+//   uint32   hidden size, which must equal kNnueHiddenSize
+//   int16    first layer weights, [kNnueInputSize][kNnueHiddenSize]
+//   int16    first layer biases, [kNnueHiddenSize]
+//   int8     output weights, [2 * kNnueHiddenSize], side to move first
+//   int32    output bias
+const int kNnueInputSize = 2 * kNumberOfPieces * 64;
+const int kNnueHiddenSize = 256;
+
+const int kNnueActivationScale = 127;
+const int kNnueWeightScale = 64;
+// Centipawns per unit of output, before quantization.
+const int kNnueOutputScale = 400;
+
+// The hidden layers of one position, indexed by perspective.
+struct alignas(32) NnueAccumulator {
+  int16_t values[2][kNnueHiddenSize];
+};
+
+// A piece on a square, one input of the network.
+struct NnueFeature {
+  Color color;
+  Piece piece;
+  int square;
+};
+
+class NnueNetwork {
+ public:
+  // Replaces the weights with those in the file at path. On failure the
+  // network is left unloaded and error says why.
+  bool Load(const std::string& path, std::string& error);
+  bool Loaded() const { return loaded_; }
+
+  // Sets accumulator to the hidden layers of state from scratch.
+  void Refresh(const State& state, NnueAccumulator& accumulator) const;
+  // Sets accumulator to parent with the removed inputs turned off and the
+  // added ones turned on.
+  void Update(const NnueAccumulator& parent, const NnueFeature* removed,
+              int removed_count, const NnueFeature* added, int added_count,
+              NnueAccumulator& accumulator) const;
+
+  // Centipawns for side_to_move.
+  int Evaluate(const NnueAccumulator& accumulator, Color side_to_move) const;
+
+ private:
+  bool loaded_ = false;
+
+  std::vector<int16_t> weights_;
+  std::vector<int16_t> biases_;
+  std::vector<int8_t> output_weights_;
+  int32_t output_bias_ = 0;
+};
+
+// The accumulators along the line the search is on, one per ply. A push
+// only notes which inputs the move changed; the accumulator is brought up
+// to date when the position is evaluated, from the nearest one above it
+// that is, so nodes that are never evaluated cost next to nothing.
+class NnueAccumulatorStack {
+ public:
+  // Starts the stack at state, the root of a search. Without a loaded
+  // network, pushes and pops do nothing and Current must not be called.
+  void Reset(const NnueNetwork& network, const State& state);
+
+  // Records the move that led to state, which has already been made.
+  void Push(const State& state, const Action& action, const Undo& undo) {
+    if (enabled_) {
+      Record(state, action, undo);
+    }
+  }
+  void PushNullMove() {
+    if (enabled_) {
+      PushEntry();
+    }
+  }
+  void Pop() {
+    if (enabled_) {
+      top_--;
+    }
+  }
+
+  // The accumulator of the newest position.
+  const NnueAccumulator& Current(const NnueNetwork& network);
+
+ private:
+  // A move takes off at most the mover and a captured piece or the
+  // castling king, and puts back the mover and the king.
+  struct Entry {
+    NnueAccumulator accumulator;
+    bool computed;
+    int removed_count;
+    int added_count;
+    NnueFeature removed[2];
+    NnueFeature added[2];
+  };
+
+  std::vector<Entry> entries_;
+  int top_ = 0;
+  bool enabled_ = false;
+
+  Entry& PushEntry();
+  void Record(const State& state, const Action& action, const Undo& undo);
+};
+
+}  // namespace ChessEngine
+
+#endif  // CHESS_AI_NNUE_H_
@@ -0,0 +1,62 @@
+//
+//  pawn-hash-table.h
+//  chess_ai
+//
+//  Created by Illya Starikov on 10/14/26.
+//  Copyright 2026. Illya Starikov. All rights reserved.
+//
+
+#ifndef CHESS_AI_PAWN_HASH_TABLE_H_
+#define CHESS_AI_PAWN_HASH_TABLE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "bitboard.h"
+#include "piece-square-tables.h"
+
+namespace ChessEngine {
+
+// The pawn structure terms of one pawn formation.
+struct PawnEntry {
+  uint64_t key;
+  Score score;
+  Bitboard passed[2];
+};
+
+// Pawn structure results keyed by the pawn-only Zobrist key. Pawns move far
+// less often than pieces, so most leaves along a line share a formation and
+// find it here. Each search thread owns one, so slots need no locking; a
+// slot simply holds the last formation that hashed to it.
+class PawnHashTable {
+ public:
+  // 2^14 entries of 32 bytes: half a megabyte, well within L2.
+  static const size_t kDefaultEntries = size_t{1} << 14;
+
+  // Entries must be a power of two.
+  explicit PawnHashTable(size_t entries = kDefaultEntries)
+      : entries_(entries), mask_(entries - 1) {}
+
+  // Copies the entry for key into entry if the table holds it.
+  bool Probe(uint64_t key, PawnEntry& entry) const {
+    const PawnEntry& slot = entries_[key & mask_];
+    if (slot.key != key) {
+      return false;
+    }
+    entry = slot;
+    return true;
+  }
+
+  void Store(const PawnEntry& entry) { entries_[entry.key & mask_] = entry; }
+
+ private:
+  // Zero-initialized slots hold key 0 with a zero score and no passed pawns:
+  // exactly the result for a board without pawns, whose key is 0.
+  std::vector<PawnEntry> entries_;
+  size_t mask_;
+};
+
+}  // namespace ChessEngine
+
+#endif  // CHESS_AI_PAWN_HASH_TABLE_H_
@@ -0,0 +1,138 @@
+//
+//  perft.cpp
+//  chess_ai
+//
+//  Created by Illya Starikov on 10/14/26.
+//  Copyright 2026. Illya Starikov. All rights reserved.
+//
+
+#include "perft.h"
+
+#include <iomanip>
+#include <string>
+#include <vector>
+
+#include "chess-ai.h"
+#include "fen-parser.h"
+#include "move-list.h"
+#include "timer.h"
+#include "uci.h"
+
+namespace ChessEngine {
+
+namespace {
+
+struct PerftPosition {
+  const char* name;
+  const char* fen;
+  std::vector<uint64_t> counts;  // Known counts for depths 1, 2, ...
+};
+
+// Positions from the Chess Programming Wiki perft results page, chosen to
+// cover castling through and out of check, en passant pins and promotions.
+const std::vector<PerftPosition> kPerftSuite = {
+    {"startpos", kStartingFen, {20, 400, 8902, 197281, 4865609, 119060324}},
+    {"kiwipete",
+     "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+     {48, 2039, 97862, 4085603, 193690690}},
+    {"endgame", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+     {14, 191, 2812, 43238, 674624, 11030083}},
+    {"promotions",
+     "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+     {6, 264, 9467, 422333, 15833292}},
+    {"discovered",
+     "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+     {44, 1486, 62379, 2103487, 89941194}},
+    {"middlegame",
+     "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 "
+     "10",
+     {46, 2079, 89890, 3894594, 164075551}},
+};
+
+}  // namespace
+
+uint64_t Perft::Count(State& state, int depth) {
+  if (depth <= 0) {
+    return 1;
+  }
+
+  MoveList actions;
+  ChessAI::GenerateActions(state, kAllMoves, actions);
+  if (depth == 1) {
+    return actions.Size();
+  }
+
+  uint64_t nodes = 0;
+  for (const Action& action : actions) {
+    Undo undo = ChessAI::MakeMove(state, action);
+    nodes += Count(state, depth - 1);
+    ChessAI::UnmakeMove(state, action, undo);
+  }
+
+  return nodes;
+}
+
+uint64_t Perft::Divide(State& state, int depth, std::ostream& output) {
+  uint64_t total = 0;
+
+  MoveList actions;
+  ChessAI::GenerateActions(state, kAllMoves, actions);
+  for (const Action& action : actions) {
+    Undo undo = ChessAI::MakeMove(state, action);
+    uint64_t nodes = Count(state, depth - 1);
+    ChessAI::UnmakeMove(state, action, undo);
+
+    output << UciProtocol::MoveToString(action) << ": " << nodes << "\n";
+    total += nodes;
+  }
+
+  output << "\nNodes: " << total << "\n";
+  return total;
+}
+
+bool Perft::RunSuite(int depth, std::ostream& output) {
+  FenParser parser;
+  Timer timer;
+
+  bool all_match = true;
+  uint64_t total_nodes = 0;
+  double total_seconds = 0;
+
+  for (const PerftPosition& position : kPerftSuite) {
+    State state = parser(position.fen);
+
+    timer.Start();
+    uint64_t nodes = Count(state, depth);
+    double seconds = timer.Elapsed();
+
+    total_nodes += nodes;
+    total_seconds += seconds;
+
+    std::string verdict = "unknown";
+    if (static_cast<size_t>(depth) <= position.counts.size()) {
+      bool match = nodes == position.counts[depth - 1];
+      verdict = match ? "ok"
+                      : "MISMATCH, expected " +
+                            std::to_string(position.counts[depth - 1]);
+      all_match = all_match && match;
+    }
+
+    output << std::left << std::setw(12) << position.name << std::right
+           << " depth " << depth << "  nodes " << std::setw(11) << nodes
+           << "  time " << std::fixed << std::setprecision(3) << seconds
+           << "s  nps " << std::setw(10)
+           << static_cast<uint64_t>(nodes / std::max(seconds, 1e-6)) << "  "
+           << verdict << "\n";
+  }
+
+  output << std::left << std::setw(12) << "total" << std::right << " depth "
+         << depth << "  nodes " << std::setw(11) << total_nodes << "  time "
+         << std::fixed << std::setprecision(3) << total_seconds << "s  nps "
+         << std::setw(10)
+         << static_cast<uint64_t>(total_nodes / std::max(total_seconds, 1e-6))
+         << "\n";
+
+  return all_match;
+}
+
+}  // namespace ChessEngine
@@ -0,0 +1,37 @@
+//
+//  perft.h
+//  chess_ai
+//
+//  Created by Illya Starikov on 10/14/26.
+//  Copyright 2026. Illya Starikov. All rights reserved.
+//
+
+#ifndef CHESS_AI_PERFT_H_
+#define CHESS_AI_PERFT_H_
+
+#include <cstdint>
+#include <ostream>
+
+#include "state.h"
+
+namespace ChessEngine {
+
+// Move generator checks: counts the leaves of the legal move tree and
+// compares them with the published counts of well-known positions.
+class Perft {
+ public:
+  // Number of move sequences depth plies long. The state is walked with
+  // make/unmake and is unchanged on return.
+  static uint64_t Count(State& state, int depth);
+
+  // Prints the count below each root move, then the total.
+  static uint64_t Divide(State& state, int depth, std::ostream& output);
+
+  // Counts every built-in position to the given depth, printing nodes,
+  // time and speed. Returns false if a known count disagrees.
+  static bool RunSuite(int depth, std::ostream& output);
+};
+
+}  // namespace ChessEngine
+
+#endif  // CHESS_AI_PERFT_H_
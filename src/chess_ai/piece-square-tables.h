@@ -0,0 +1,211 @@
+//
+//  piece-square-tables.h
+//  chess_ai
+//
+//  Created by Illya Starikov on 10/14/26.
+//  Copyright 2026. Illya Starikov. All rights reserved.
+//
+
+#ifndef CHESS_AI_PIECE_SQUARE_TABLES_H_
+#define CHESS_AI_PIECE_SQUARE_TABLES_H_
+
+#include "bitboard.h"
+#include "chess-pieces.h"
+#include "color.h"
+#include "constants.h"
+
+namespace ChessEngine {
+
+// A middlegame and an endgame score in centipawns. Evaluation blends the two
+// by how much material is left (the game phase).
+struct Score {
+  int middlegame;
+  int endgame;
+
+  constexpr Score operator+(const Score& right) const {
+    return {middlegame + right.middlegame, endgame + right.endgame};
+  }
+  constexpr Score operator-(const Score& right) const {
+    return {middlegame - right.middlegame, endgame - right.endgame};
+  }
+  constexpr Score operator-() const { return {-middlegame, -endgame}; }
+  constexpr Score operator*(int factor) const {
+    return {middlegame * factor, endgame * factor};
+  }
+  Score& operator+=(const Score& right) { return *this = *this + right; }
+  Score& operator-=(const Score& right) { return *this = *this - right; }
+  constexpr bool operator==(const Score& right) const {
+    return middlegame == right.middlegame && endgame == right.endgame;
+  }
+};
+
+// Phase each piece adds while on the board; the starting position has
+// kMaxPhase and bare kings have none. Indexed by Piece.
+constexpr int kPhaseWeights[kNumberOfPieces] = {0, 4, 2, 1, 1, 0};
+constexpr int kMaxPhase = 24;
+
+// Material, indexed by Piece. The king is never traded, so it has none.
+constexpr Score kMaterial[kNumberOfPieces] = {
+    {0, 0}, {1025, 936}, {477, 512}, {365, 297}, {337, 281}, {82, 94}};
+
+// Bonuses for white pieces, as the board is drawn: the first row is the
+// eighth rank, a8 to h8. Black reads the same tables mirrored. Indexed by
+// Piece, middlegame then endgame.
+constexpr int kSquareTables[kNumberOfPieces][2][64] = {
+    // King: tucked away behind its pawns, then active in the centre.
+    {{-30, -40, -40, -50, -50, -40, -40, -30,  //
+      -30, -40, -40, -50, -50, -40, -40, -30,  //
+      -30, -40, -40, -50, -50, -40, -40, -30,  //
+      -30, -40, -40, -50, -50, -40, -40, -30,  //
+      -20, -30, -30, -40, -40, -30, -30, -20,  //
+      -10, -20, -20, -20, -20, -20, -20, -10,  //
+      20,  20,  0,   0,   0,   0,   20,  20,   //
+      20,  30,  10,  0,   0,   10,  30,  20},  //
+     {-50, -40, -30, -20, -20, -30, -40, -50,  //
+      -30, -20, -10, 0,   0,   -10, -20, -30,  //
+      -30, -10, 20,  30,  30,  20,  -10, -30,  //
+      -30, -10, 30,  40,  40,  30,  -10, -30,  //
+      -30, -10, 30,  40,  40,  30,  -10, -30,  //
+      -30, -10, 20,  30,  30,  20,  -10, -30,  //
+      -30, -30, 0,   0,   0,   0,   -30, -30,  //
+      -50, -30, -30, -30, -30, -30, -30, -50}},
+    // Queen
+    {{-20, -10, -10, -5, -5, -10, -10, -20,  //
+      -10, 0,   0,   0,  0,  0,   0,   -10,  //
+      -10, 0,   5,   5,  5,  5,   0,   -10,  //
+      -5,  0,   5,   5,  5,  5,   0,   -5,   //
+      0,   0,   5,   5,  5,  5,   0,   -5,   //
+      -10, 5,   5,   5,  5,  5,   0,   -10,  //
+      -10, 0,   5,   0,  0,  0,   0,   -10,  //
+      -20, -10, -10, -5, -5, -10, -10, -20},  //
+     {-20, -10, -10, -5, -5, -10, -10, -20,  //
+      -10, 0,   5,   5,  5,  5,   0,   -10,  //
+      -10, 5,   10,  10, 10, 10,  5,   -10,  //
+      -5,  5,   10,  15, 15, 10,  5,   -5,   //
+      -5,  5,   10,  15, 15, 10,  5,   -5,   //
+      -10, 5,   10,  10, 10, 10,  5,   -10,  //
+      -10, 0,   5,   5,  5,  5,   0,   -10,  //
+      -20, -10, -10, -5, -5, -10, -10, -20}},
+    // Rook: the seventh rank and the centre files.
+    {{0,  0,  0,  0,  0,  0,  0,  0,   //
+      5,  10, 10, 10, 10, 10, 10, 5,   //
+      -5, 0,  0,  0,  0,  0,  0,  -5,  //
+      -5, 0,  0,  0,  0,  0,  0,  -5,  //
+      -5, 0,  0,  0,  0,  0,  0,  -5,  //
+      -5, 0,  0,  0,  0,  0,  0,  -5,  //
+      -5, 0,  0,  0,  0,  0,  0,  -5,  //
+      0,  0,  0,  5,  5,  0,  0,  0},  //
+     {0, 0,  0,  0,  0,  0,  0,  0,  //
+      5, 10, 10, 10, 10, 10, 10, 5,  //
+      0, 0,  0,  0,  0,  0,  0,  0,  //
+      0, 0,  0,  0,  0,  0,  0,  0,  //
+      0, 0,  0,  0,  0,  0,  0,  0,  //
+      0, 0,  0,  0,  0,  0,  0,  0,  //
+      0, 0,  0,  0,  0,  0,  0,  0,  //
+      0, 0,  0,  0,  0,  0,  0,  0}},
+    // Bishop: long diagonals, away from the rim.
+    {{-20, -10, -10, -10, -10, -10, -10, -20,  //
+      -10, 0,   0,   0,   0,   0,   0,   -10,  //
+      -10, 0,   5,   10,  10,  5,   0,   -10,  //
+      -10, 5,   5,   10,  10,  5,   5,   -10,  //
+      -10, 0,   10,  10,  10,  10,  0,   -10,  //
+      -10, 10,  10,  10,  10,  10,  10,  -10,  //
+      -10, 5,   0,   0,   0,   0,   5,   -10,  //
+      -20, -10, -10, -10, -10, -10, -10, -20},  //
+     {-20, -10, -10, -10, -10, -10, -10, -20,  //
+      -10, 0,   0,   0,   0,   0,   0,   -10,  //
+      -10, 0,   5,   10,  10,  5,   0,   -10,  //
+      -10, 5,   10,  10,  10,  10,  5,   -10,  //
+      -10, 5,   10,  10,  10,  10,  5,   -10,  //
+      -10, 0,   5,   10,  10,  5,   0,   -10,  //
+      -10, 0,   0,   0,   0,   0,   0,   -10,  //
+      -20, -10, -10, -10, -10, -10, -10, -20}},
+    // Knight: the centre, never the corners.
+    {{-50, -40, -30, -30, -30, -30, -40, -50,  //
+      -40, -20, 0,   0,   0,   0,   -20, -40,  //
+      -30, 0,   10,  15,  15,  10,  0,   -30,  //
+      -30, 5,   15,  20,  20,  15,  5,   -30,  //
+      -30, 0,   15,  20,  20,  15,  0,   -30,  //
+      -30, 5,   10,  15,  15,  10,  5,   -30,  //
+      -40, -20, 0,   5,   5,   0,   -20, -40,  //
+      -50, -40, -30, -30, -30, -30, -40, -50},  //
+     {-50, -40, -30, -30, -30, -30, -40, -50,  //
+      -40, -20, 0,   0,   0,   0,   -20, -40,  //
+      -30, 0,   10,  15,  15,  10,  0,   -30,  //
+      -30, 5,   15,  20,  20,  15,  5,   -30,  //
+      -30, 0,   15,  20,  20,  15,  0,   -30,  //
+      -30, 5,   10,  15,  15,  10,  5,   -30,  //
+      -40, -20, 0,   5,   5,   0,   -20, -40,  //
+      -50, -40, -30, -30, -30, -30, -40, -50}},
+    // Pawn: the centre early, and ever more the closer it is to promoting.
+    {{0,  0,  0,   0,   0,   0,   0,  0,   //
+      50, 50, 50,  50,  50,  50,  50, 50,  //
+      10, 10, 20,  30,  30,  20,  10, 10,  //
+      5,  5,  10,  25,  25,  10,  5,  5,   //
+      0,  0,  0,   20,  20,  0,   0,  0,   //
+      5,  -5, -10, 0,   0,   -10, -5, 5,   //
+      5,  10, 10,  -20, -20, 10,  10, 5,   //
+      0,  0,  0,   0,   0,   0,   0,  0},  //
+     {0,  0,  0,  0,  0,  0,  0,  0,   //
+      70, 70, 70, 70, 70, 70, 70, 70,  //
+      45, 45, 45, 45, 45, 45, 45, 45,  //
+      25, 25, 25, 25, 25, 25, 25, 25,  //
+      12, 12, 12, 12, 12, 12, 12, 12,  //
+      4,  4,  4,  4,  4,  4,  4,  4,   //
+      0,  0,  0,  0,  0,  0,  0,  0,   //
+      0,  0,  0,  0,  0,  0,  0,  0}}};
+
+// Material plus square bonus of every piece on every square, signed so
+// white's count up and black's down.
+struct PieceSquareScores {
+  Score scores[2][kNumberOfPieces][64];
+};
+
+constexpr PieceSquareScores GeneratePieceSquareScores() {
+  PieceSquareScores table{};
+
+  for (int piece = 0; piece < kNumberOfPieces; piece++) {
+    for (int square = 0; square < 64; square++) {
+      // The tables are drawn rank eight first; square 0 is a1.
+      int white_index = square ^ 56;
+      int black_index = square;
+
+      Score white = kMaterial[piece] +
+                    Score{kSquareTables[piece][0][white_index],
+                          kSquareTables[piece][1][white_index]};
+      Score black = kMaterial[piece] +
+                    Score{kSquareTables[piece][0][black_index],
+                          kSquareTables[piece][1][black_index]};
+
+      table.scores[kWhite][piece][square] = white;
+      table.scores[kBlack][piece][square] = -black;
+    }
+  }
+
+  return table;
+}
+
+// What each piece is worth on its square, from white's point of view. State
+// keeps the sum over the board current through every make and unmake.
+class PieceSquare {
+ public:
+  static Score Value(Color color, Piece piece, int square) {
+    return kScores.scores[color][piece][square];
+  }
+
+  // Sum of the values of every square set in the board.
+  static Score Values(Color color, Piece piece, const Bitboard& squares) {
+    Score score{0, 0};
+    for (int square : squares) {
+      score += Value(color, piece, square);
+    }
+    return score;
+  }
+
+ private:
+  static constexpr PieceSquareScores kScores = GeneratePieceSquareScores();
+};
+
+}  // namespace ChessEngine
+
+#endif  // CHESS_AI_PIECE_SQUARE_TABLES_H_
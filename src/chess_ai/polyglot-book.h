@@ -0,0 +1,75 @@
+//
+//  polyglot-book.h
+//  chess_ai
+//
+//  Created by Illya Starikov on 10/14/26.
+//  Copyright 2026. Illya Starikov. All rights reserved.
+//
+
+#ifndef CHESS_AI_POLYGLOT_BOOK_H_
+#define CHESS_AI_POLYGLOT_BOOK_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+
+#include "action.h"
+#include "state.h"
+
+namespace ChessEngine {
+
+// An opening book in the Polyglot format. The file is a sorted array of
+// 16-byte big-endian entries:
+//   uint64  key of the position, Polyglot's own Zobrist hash
+//   uint16  move: to file, to rank, from file, from rank (3 bits each,
+//           lowest first), then the promotion piece (1 knight ... 4 queen)
+//   uint16  weight, how often the move should be played
+//   uint32  learning data, unused
+// The file is mapped into memory once and searched in place, so opening a
+// book of any size costs nothing until a position is looked up.
+class PolyglotBook {
+ public:
+  PolyglotBook();
+  ~PolyglotBook();
+
+  PolyglotBook(const PolyglotBook& other) = delete;
+  PolyglotBook& operator=(const PolyglotBook& other) = delete;
+
+  // Maps the book at path, replacing any open one. On failure no book is
+  // open and error says why.
+  bool Open(const std::string& path, std::string& error);
+  void Close();
+  bool IsOpen() const { return entries_ != nullptr; }
+
+  // Picks one of the book moves for state at random, each as likely as its
+  // weight. Fails when the position is not in the book or when none of its
+  // moves is legal.
+  bool Probe(const State& state, Action& action);
+
+  // Polyglot key of state. It differs from State::key_: the random numbers
+  // are fixed by the format, and the en passant file only counts when a
+  // pawn can actually take.
+  static uint64_t Key(const State& state);
+
+ private:
+  const unsigned char* entries_;
+  size_t entry_count_;
+  size_t mapped_size_;
+
+  std::mt19937 random_;
+
+  // Index of the first entry whose key is not below key.
+  size_t LowerBound(uint64_t key) const;
+
+  uint64_t EntryKey(size_t index) const;
+  uint16_t EntryMove(size_t index) const;
+  uint16_t EntryWeight(size_t index) const;
+
+  // The legal action of state the book move names, if there is one.
+  static bool MatchMove(const State& state, uint16_t move, Action& action);
+};
+
+}  // namespace ChessEngine
+
+#endif  // CHESS_AI_POLYGLOT_BOOK_H_
@@ -0,0 +1,145 @@
+//
+//  search-stats.h
+//  chess_ai
+//
+//  Created by Illya Starikov on 10/14/26.
+//  Copyright 2026. Illya Starikov. All rights reserved.
+//
+
+#ifndef CHESS_AI_SEARCH_STATS_H_
+#define CHESS_AI_SEARCH_STATS_H_
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+namespace ChessEngine {
+
+// Search instrumentation is compiled in with make STATS=1. Every counter
+// update is guarded by kSearchStats, so without the flag the compiler
+// drops them and the search runs exactly as before.
+#ifdef SEARCH_STATS
+const bool kSearchStats = true;
+#else
+const bool kSearchStats = false;
+#endif
+
+// Beta cutoffs are counted by the index of the move that caused them;
+// the last slot takes every later move.
+const int kCutoffSlots = 8;
+
+// What one search thread did, summed over a search. Times are in
+// nanoseconds and include the clock reads themselves, so they are best
+// compared with each other rather than with the total.
+struct SearchStats {
+  uint64_t quiescence_nodes = 0;
+  uint64_t table_probes = 0;
+  uint64_t table_hits = 0;
+  uint64_t cutoffs[kCutoffSlots] = {};
+  // Move generation and ordering, make and unmake, static evaluation.
+  uint64_t generation_time = 0;
+  uint64_t make_move_time = 0;
+  uint64_t evaluation_time = 0;
+
+  void AddCutoff(int move_index) {
+    cutoffs[move_index < kCutoffSlots ? move_index : kCutoffSlots - 1]++;
+  }
+
+  uint64_t Cutoffs() const {
+    uint64_t total = 0;
+    for (uint64_t count : cutoffs) {
+      total += count;
+    }
+    return total;
+  }
+
+  // Share of cutoffs made by the first move searched, the measure of how
+  // good move ordering is.
+  double FirstMoveCutoffRate() const {
+    uint64_t total = Cutoffs();
+    return total == 0 ? 0 : static_cast<double>(cutoffs[0]) / total;
+  }
+
+  SearchStats& operator+=(const SearchStats& other) {
+    quiescence_nodes += other.quiescence_nodes;
+    table_probes += other.table_probes;
+    table_hits += other.table_hits;
+    for (int i = 0; i < kCutoffSlots; i++) {
+      cutoffs[i] += other.cutoffs[i];
+    }
+    generation_time += other.generation_time;
+    make_move_time += other.make_move_time;
+    evaluation_time += other.evaluation_time;
+    return *this;
+  }
+
+  // One UCI info line for a completed iteration, times in milliseconds, as
+  // a string so that GUIs pass it through:
+  //   info string stats depth 6 time 41 nodes ... cutoffs 1:... 8+:...
+  std::string ToInfo(int depth, double iteration_seconds,
+                     uint64_t nodes) const {
+    std::ostringstream info;
+    info << std::fixed << std::setprecision(1) << "info string stats depth "
+         << depth << " time " << iteration_seconds * 1000 << " nodes "
+         << nodes << " qnodes " << quiescence_nodes << " ttprobes "
+         << table_probes << " tthits " << table_hits << " firstcut "
+         << 100 * FirstMoveCutoffRate() << "% cutoffs";
+    for (int i = 0; i < kCutoffSlots; i++) {
+      info << " " << i + 1 << (i == kCutoffSlots - 1 ? "+:" : ":")
+           << cutoffs[i];
+    }
+    info << " movegen " << generation_time / 1e6 << " make "
+         << make_move_time / 1e6 << " eval " << evaluation_time / 1e6;
+    return info.str();
+  }
+
+  // The same as a JSON object, times in milliseconds.
+  std::string ToJson() const {
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(3)
+         << "{\"qnodes\":" << quiescence_nodes
+         << ",\"ttprobes\":" << table_probes << ",\"tthits\":" << table_hits
+         << ",\"firstcut\":" << FirstMoveCutoffRate() << ",\"cutoffs\":[";
+    for (int i = 0; i < kCutoffSlots; i++) {
+      json << (i == 0 ? "" : ",") << cutoffs[i];
+    }
+    json << "],\"movegen\":" << generation_time / 1e6
+         << ",\"make\":" << make_move_time / 1e6
+         << ",\"eval\":" << evaluation_time / 1e6 << "}";
+    return json.str();
+  }
+};
+
+// Adds the time until it goes out of scope to total, when stats are on.
+class StatsTimer {
+ public:
+  explicit StatsTimer(uint64_t& total) : total_(total), start_(0) {
+    if (kSearchStats) {
+      start_ = Now();
+    }
+  }
+  ~StatsTimer() {
+    if (kSearchStats) {
+      total_ += Now() - start_;
+    }
+  }
+
+  StatsTimer(const StatsTimer& other) = delete;
+  StatsTimer& operator=(const StatsTimer& other) = delete;
+
+ private:
+  uint64_t& total_;
+  uint64_t start_;
+
+  static uint64_t Now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+};
+
+}  // namespace ChessEngine
+
+#endif  // CHESS_AI_SEARCH_STATS_H_
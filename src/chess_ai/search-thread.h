@@ -0,0 +1,48 @@
+//
+//  search-thread.h
+//  chess_ai
+//
+//  Created by Illya Starikov on 10/14/26.
+//  Copyright 2026. Illya Starikov. All rights reserved.
+//
+
+#ifndef CHESS_AI_SEARCH_THREAD_H_
+#define CHESS_AI_SEARCH_THREAD_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "chess-history.h"
+#include "constants.h"
+#include "move-ordering.h"
+#include "nnue.h"
+#include "pawn-hash-table.h"
+#include "search-stats.h"
+
+namespace ChessEngine {
+
+// Everything one search thread keeps to itself while it walks the tree.
+// Nothing here is shared, so none of it needs locking.
+struct SearchThread {
+  MoveHistory move_history;
+  // The move picker's lists, one set per ply from the root.
+  std::vector<MovePickerBuffers> move_buffers =
+      std::vector<MovePickerBuffers>(kMaxSearchPly + 1);
+  // The game so far, followed by the moves from the root to the node.
+  PerceptSequence history;
+  PawnHashTable pawn_table;
+  // Follows history move for move, for the network evaluation.
+  NnueAccumulatorStack accumulators;
+
+  // Nodes visited, quiescence included, and the count at which the clock
+  // is next read.
+  uint64_t nodes = 0;
+  uint64_t next_clock_check = 0;
+
+  // Only counted with make STATS=1.
+  SearchStats stats;
+};
+
+}  // namespace ChessEngine
+
+#endif  // CHESS_AI_SEARCH_THREAD_H_
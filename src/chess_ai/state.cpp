@@ -10,11 +10,57 @@
 
 namespace ChessEngine {
 
+uint64_t State::ComputeKey() const noexcept {
+  uint64_t key = 0;
+
+  for (int i = 0; i < kNumberOfPieces; i++) {
+    Piece piece = MoveEngine::IntToPiece(i);
+    key ^= Zobrist::PieceKeys(kWhite, piece, Pieces(kWhite, piece));
+    key ^= Zobrist::PieceKeys(kBlack, piece, Pieces(kBlack, piece));
+  }
+
+  key ^= Zobrist::CastlingKeys(castling_squares_);
+  key ^= Zobrist::EnPassantKeys(en_passant_squares_);
+
+  if (color_at_play_ == kBlack) {
+    key ^= Zobrist::SideKey();
+  }
+
+  return key;
+}
+
+uint64_t State::ComputePawnKey() const noexcept {
+  return Zobrist::PieceKeys(kWhite, kPawn, Pieces(kWhite, kPawn)) ^
+         Zobrist::PieceKeys(kBlack, kPawn, Pieces(kBlack, kPawn));
+}
+
+Score State::ComputeScore() const noexcept {
+  Score score{0, 0};
+
+  for (int i = 0; i < kNumberOfPieces; i++) {
+    Piece piece = MoveEngine::IntToPiece(i);
+    score += PieceSquare::Values(kWhite, piece, Pieces(kWhite, piece));
+    score += PieceSquare::Values(kBlack, piece, Pieces(kBlack, piece));
+  }
+
+  return score;
+}
+
+int State::ComputePhase() const noexcept {
+  int phase = 0;
+
+  for (int i = 0; i < kNumberOfPieces; i++) {
+    phase += kPhaseWeights[i] * pieces_[i].PopCount();
+  }
+
+  return phase;
+}
+
 bool State::operator==(const State& other) const noexcept {
-  return color_at_play_ == other.color_at_play_ &&
+  // Differing keys settle most comparisons without touching the boards.
+  return key_ == other.key_ && color_at_play_ == other.color_at_play_ &&
          all_whites_ == other.all_whites_ &&
-         all_blacks_ == other.all_blacks_ && whites_ == other.whites_ &&
-         blacks_ == other.blacks_ &&
+         all_blacks_ == other.all_blacks_ && pieces_ == other.pieces_ &&
          en_passant_squares_ == other.en_passant_squares_ &&
          castling_squares_ == other.castling_squares_;
 }
@@ -33,13 +79,15 @@ std::ostream& operator<<(std::ostream& os, const ChessEngine::State& object) {
 
   std::map<int, char> mappings;
 
-  for (int i = 0; i < 6; i++) {
-    for (int index : object.whites_[i].ToIndices()) {
+  for (int i = 0; i < ChessEngine::kNumberOfPieces; i++) {
+    ChessEngine::Piece piece = ChessEngine::MoveEngine::IntToPiece(i);
+
+    for (int index : object.Pieces(ChessEngine::kWhite, piece).ToIndices()) {
       mappings[index] =
           toupper(piece_to_char[ChessEngine::MoveEngine::IntToPiece(i)]);
     }
 
-    for (int index : object.blacks_[i].ToIndices()) {
+    for (int index : object.Pieces(ChessEngine::kBlack, piece).ToIndices()) {
       mappings[index] =
           tolower(piece_to_char[ChessEngine::MoveEngine::IntToPiece(i)]);
     }
@@ -14,12 +14,15 @@
 #include <map>
 #include <ostream>
 #include <sstream>
-#include <vector>
+#include <type_traits>
 
 #include "bitboard.h"
 #include "chess-engine.h"
 #include "chess-pieces.h"
 #include "color.h"
+#include "constants.h"
+#include "piece-square-tables.h"
+#include "zobrist.h"
 
 namespace ChessEngine {
 
@@ -33,28 +36,63 @@ namespace ChessEngine {
 
 class State {
  public:
-  Color color_at_play_;
+  // Piece-type boards shared by both colors. A side's pieces of one type are
+  // the intersection with that side's occupancy board, which keeps the whole
+  // State trivially copyable and within two cache lines.
+  PieceBoards pieces_;
 
   Bitboard all_whites_;
   Bitboard all_blacks_;
 
-  std::vector<Bitboard> whites_;
-  std::vector<Bitboard> blacks_;
-
   Bitboard en_passant_squares_;
   Bitboard castling_squares_;
 
-  State(Color color_at_play, const Bitboard& all_whites,
-        const Bitboard& all_blacks, const std::vector<Bitboard>& whites,
-        const std::vector<Bitboard>& blacks, const Bitboard& en_passant_squares,
+  Color color_at_play_;
+
+  // Zobrist key of the position, kept current by ChessAI::MakeMove.
+  uint64_t key_;
+  // Zobrist key of the pawns alone, for the pawn hash table.
+  uint64_t pawn_key_;
+
+  // Material and square bonuses of every piece, white's minus black's, and
+  // the game phase, both kept current by ChessAI::MakeMove.
+  Score psqt_;
+  int phase_;
+
+  State() = default;
+  State(Color color_at_play, const PieceBoards& whites,
+        const PieceBoards& blacks, const Bitboard& en_passant_squares,
         const Bitboard& castling_squares)
-      : color_at_play_(color_at_play),
-        all_whites_(all_whites),
-        all_blacks_(all_blacks),
-        whites_(whites),
-        blacks_(blacks),
+      : all_whites_(MoveEngine::AllBitboardsInOneBoard(whites)),
+        all_blacks_(MoveEngine::AllBitboardsInOneBoard(blacks)),
         en_passant_squares_(en_passant_squares),
-        castling_squares_(castling_squares) {}
+        castling_squares_(castling_squares),
+        color_at_play_(color_at_play) {
+    for (int i = 0; i < kNumberOfPieces; i++) {
+      pieces_[i] = whites[i] | blacks[i];
+    }
+    key_ = ComputeKey();
+    pawn_key_ = ComputePawnKey();
+    psqt_ = ComputeScore();
+    phase_ = ComputePhase();
+  }
+
+  const Bitboard& Occupancy(Color color) const noexcept {
+    return color == kWhite ? all_whites_ : all_blacks_;
+  }
+
+  Bitboard Pieces(Color color, Piece piece) const noexcept {
+    return pieces_[MoveEngine::PieceToInt(piece)] & Occupancy(color);
+  }
+
+  Bitboard AllPieces() const noexcept { return all_whites_ | all_blacks_; }
+
+  // Hashes the position from scratch.
+  uint64_t ComputeKey() const noexcept;
+  uint64_t ComputePawnKey() const noexcept;
+  // Sums the piece-square scores and the phase from scratch.
+  Score ComputeScore() const noexcept;
+  int ComputePhase() const noexcept;
 
   bool operator==(const State& other) const noexcept;
   bool operator!=(const State& other) const noexcept;
@@ -63,6 +101,22 @@ class State {
   friend std::ostream& ::operator<<(std::ostream& os, const State& object);
 };
 
+// The parts of a State that MakeMove overwrites and UnmakeMove cannot rebuild
+// from the Action alone.
+struct Undo {
+  Bitboard en_passant_squares;
+  Bitboard castling_squares;
+  Bitboard king_before_castling;
+  uint64_t key;
+  uint64_t pawn_key;
+  Score psqt;
+  int phase;
+};
+
+static_assert(std::is_trivially_copyable<State>::value,
+              "State is copied at every node and must stay a flat value");
+static_assert(sizeof(State) <= 128, "State should fit in two cache lines");
+
 }  // namespace ChessEngine
 
 #endif  // CHESS_AI_STATE_H_
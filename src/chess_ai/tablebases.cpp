@@ -0,0 +1,141 @@
+//
+//  tablebases.cpp
+//  chess_ai
+//
+//  Created by Illya Starikov on 10/14/26.
+//  Copyright 2026. Illya Starikov. All rights reserved.
+//
+
+#include "tablebases.h"
+
+#ifdef SYZYGY
+#include <tbprobe.h>
+
+#include <mutex>
+
+#include "chess-ai.h"
+#endif
+
+namespace ChessEngine {
+
+int Tablebases::max_pieces_ = 0;
+
+#ifdef SYZYGY
+
+namespace {
+
+std::mutex root_probe_mutex;
+
+// Fathom takes the en passant target, the square the pawn skipped, where
+// the state keeps the pawn itself.
+unsigned EnPassantTarget(const State& state) {
+  if (state.en_passant_squares_ == Bitboard(0)) {
+    return 0;
+  }
+
+  int pawn = state.en_passant_squares_.Lsb();
+  return state.color_at_play_ == kWhite ? pawn + 8 : pawn - 8;
+}
+
+ChessOutcome WdlOutcome(unsigned wdl) {
+  if (wdl == TB_WIN) {
+    return kWin;
+  } else if (wdl == TB_LOSS) {
+    return kLoss;
+  }
+  return kDraw;
+}
+
+uint64_t Board(const State& state, Piece piece) {
+  return state.pieces_[MoveEngine::PieceToInt(piece)].board_;
+}
+
+}  // namespace
+
+bool Tablebases::Init(const std::string& path, std::string& error) {
+  max_pieces_ = 0;
+  if (!tb_init(path.c_str())) {
+    error = "cannot initialize tablebases in " + path;
+    return false;
+  }
+  if (TB_LARGEST == 0) {
+    error = "no tablebase files in " + path;
+    return false;
+  }
+
+  max_pieces_ = static_cast<int>(TB_LARGEST);
+  return true;
+}
+
+bool Tablebases::ProbeWdl(const State& state, ChessOutcome& outcome) {
+  if (!Covers(state)) {
+    return false;
+  }
+
+  unsigned result = tb_probe_wdl(
+      state.all_whites_.board_, state.all_blacks_.board_,
+      Board(state, kKing), Board(state, kQueen), Board(state, kRook),
+      Board(state, kBishop), Board(state, kKnight), Board(state, kPawn), 0, 0,
+      EnPassantTarget(state), state.color_at_play_ == kWhite);
+  if (result == TB_RESULT_FAILED) {
+    return false;
+  }
+
+  outcome = WdlOutcome(result);
+  return true;
+}
+
+bool Tablebases::ProbeRoot(const State& state, int halfmove_clock,
+                           Action& action, ChessOutcome& outcome) {
+  if (!Covers(state)) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(root_probe_mutex);
+  unsigned result = tb_probe_root(
+      state.all_whites_.board_, state.all_blacks_.board_,
+      Board(state, kKing), Board(state, kQueen), Board(state, kRook),
+      Board(state, kBishop), Board(state, kKnight), Board(state, kPawn),
+      static_cast<unsigned>(halfmove_clock), 0, EnPassantTarget(state),
+      state.color_at_play_ == kWhite, nullptr);
+  if (result == TB_RESULT_FAILED || result == TB_RESULT_CHECKMATE ||
+      result == TB_RESULT_STALEMATE) {
+    return false;
+  }
+
+  static const Piece kPromotions[] = {kPawn, kQueen, kRook, kBishop, kKnight};
+  int from = static_cast<int>(TB_GET_FROM(result));
+  int to = static_cast<int>(TB_GET_TO(result));
+  unsigned promotion = TB_GET_PROMOTES(result);
+
+  for (const Action& candidate : ChessAI::Actions(state)) {
+    if (candidate.From() == from && candidate.To() == to &&
+        candidate.WasPromotion() == (promotion != TB_PROMOTES_NONE) &&
+        (!candidate.WasPromotion() ||
+         candidate.PromotedTo() == kPromotions[promotion])) {
+      action = candidate;
+      outcome = WdlOutcome(TB_GET_WDL(result));
+      return true;
+    }
+  }
+
+  return false;
+}
+
+#else
+
+bool Tablebases::Init(const std::string& path, std::string& error) {
+  error = "cannot open " + path + ": built without Syzygy support " +
+          "(make SYZYGY=1)";
+  return false;
+}
+
+bool Tablebases::ProbeWdl(const State&, ChessOutcome&) { return false; }
+
+bool Tablebases::ProbeRoot(const State&, int, Action&, ChessOutcome&) {
+  return false;
+}
+
+#endif  // SYZYGY
+
+}  // namespace ChessEngine
@@ -0,0 +1,56 @@
+//
+//  tablebases.h
+//  chess_ai
+//
+//  Created by Illya Starikov on 10/14/26.
+//  Copyright 2026. Illya Starikov. All rights reserved.
+//
+
+#ifndef CHESS_AI_TABLEBASES_H_
+#define CHESS_AI_TABLEBASES_H_
+
+#include <string>
+
+#include "action.h"
+#include "bitboard.h"
+#include "chess-outcome.h"
+#include "state.h"
+
+namespace ChessEngine {
+
+// Syzygy endgame tablebases, probed through the Fathom library, which maps
+// the table files into memory. Support is compiled in with make SYZYGY=1;
+// otherwise Init fails and no position is ever covered. Positions with
+// castling rights are never in the tables.
+class Tablebases {
+ public:
+  // Opens the tables in path, several directories separated by ':'. On
+  // failure no tables are open and error says why.
+  static bool Init(const std::string& path, std::string& error);
+  // Pieces, kings included, in the largest table found; 0 without tables.
+  static int MaxPieces() { return max_pieces_; }
+
+  static bool Covers(const State& state) {
+    return max_pieces_ > 0 && state.castling_squares_ == Bitboard(0) &&
+           state.AllPieces().PopCount() <= max_pieces_;
+  }
+
+  // Win, draw or loss for the side to move with best play, ignoring the
+  // halfmove clock. Wins and losses the fifty-move rule turns into draws
+  // are draws. Safe to call from every search thread.
+  static bool ProbeWdl(const State& state, ChessOutcome& outcome);
+
+  // The move that keeps the best outcome for the side to move, chosen by
+  // distance to the next capture or pawn move so that wins are actually
+  // converted within the fifty-move rule. Fathom's root probe is not
+  // reentrant, so concurrent callers take turns.
+  static bool ProbeRoot(const State& state, int halfmove_clock,
+                        Action& action, ChessOutcome& outcome);
+
+ private:
+  static int max_pieces_;
+};
+
+}  // namespace ChessEngine
+
+#endif  // CHESS_AI_TABLEBASES_H_
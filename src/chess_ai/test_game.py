@@ -2,11 +2,39 @@
 
 from __future__ import annotations
 
+import os
+import stat
+import sys
+import tempfile
 import unittest
 
 from chess_client.game import ChessGame
 
 
+# Minimal UCI engine that always answers with the move given on its command
+# line, logging every command it receives.
+FAKE_ENGINE = """#!{python}
+import sys
+log = open({log!r}, "a")
+for line in sys.stdin:
+    log.write(line)
+    log.flush()
+    command = line.split()
+    if not command:
+        continue
+    if command[0] == "uci":
+        print("id name fake", flush=True)
+        print("uciok", flush=True)
+    elif command[0] == "isready":
+        print("readyok", flush=True)
+    elif command[0] == "go":
+        print("info depth 1", flush=True)
+        print("bestmove {move}", flush=True)
+    elif command[0] == "quit":
+        break
+"""
+
+
 class TestCastlingValidation(unittest.TestCase):
     """Tests for castling move generation."""
 
@@ -367,5 +395,65 @@ class TestFEN(unittest.TestCase):
         self.assertEqual(fen, result)
 
 
+class TestEngineProtocol(unittest.TestCase):
+    """Tests for talking UCI to a persistent engine process."""
+
+    def setUp(self) -> None:
+        self.directory = tempfile.TemporaryDirectory()
+        self.log = os.path.join(self.directory.name, "commands.log")
+
+    def tearDown(self) -> None:
+        self.directory.cleanup()
+
+    def _make_game(self, move: str, fen: str | None = None) -> ChessGame:
+        path = os.path.join(self.directory.name, "engine")
+        with open(path, "w") as engine:
+            engine.write(FAKE_ENGINE.format(
+                python=sys.executable, log=self.log, move=move
+            ))
+        os.chmod(path, os.stat(path).st_mode | stat.S_IEXEC)
+
+        game = ChessGame(ai_path=path, ai_time=0.1, fen=fen)
+        self.addCleanup(game.close)
+        return game
+
+    def _commands(self) -> list[str]:
+        with open(self.log) as log:
+            return [line.strip() for line in log]
+
+    def test_bestmove_parsed(self) -> None:
+        """The engine's bestmove is returned as board coordinates."""
+        game = self._make_game("e2e4")
+        self.assertEqual(game.get_ai_move(), ((4, 1), (4, 3), None))
+
+    def test_bestmove_promotion(self) -> None:
+        """A promotion suffix is returned as the promoted piece."""
+        game = self._make_game("a7a8n", fen="8/P7/8/8/8/8/8/k6K w - - 0 1")
+        self.assertEqual(game.get_ai_move(), ((0, 6), (0, 7), "N"))
+
+    def test_engine_started_once(self) -> None:
+        """Consecutive moves reuse one engine process."""
+        game = self._make_game("e2e4")
+        game.get_ai_move()
+        game.get_ai_move()
+        game.close()
+
+        commands = self._commands()
+        self.assertEqual(commands.count("uci"), 1)
+        self.assertEqual(commands.count("go movetime 100"), 2)
+        self.assertEqual(commands[-1], "quit")
+
+    def test_position_sent_as_fen(self) -> None:
+        """The current position is sent before each search."""
+        game = self._make_game("e2e4")
+        game.get_ai_move()
+        self.assertIn("position fen " + game.to_fen(), self._commands())
+
+    def test_missing_engine(self) -> None:
+        """A missing engine binary yields no move."""
+        game = ChessGame(ai_path=os.path.join(self.directory.name, "none"))
+        self.assertIsNone(game.get_ai_move())
+
+
 if __name__ == "__main__":
     unittest.main()
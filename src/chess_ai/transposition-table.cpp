@@ -0,0 +1,141 @@
+//
+//  transposition-table.cpp
+//  chess_ai
+//
+//  Created by Illya Starikov on 10/14/26.
+//  Copyright 2026. Illya Starikov. All rights reserved.
+//
+
+#include "transposition-table.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ChessEngine {
+
+namespace {
+
+// Scores at or beyond this many hundredths of a pawn read back as infinite,
+// which is how the search scores won and lost positions.
+const int kInfiniteScore = 32767;
+
+}  // namespace
+
+TranspositionTable::TranspositionTable(size_t megabytes)
+    : bucket_count_(0), generation_(0) {
+  Resize(megabytes);
+}
+
+void TranspositionTable::Resize(size_t megabytes) {
+  size_t bytes = std::max<size_t>(megabytes, 1) << 20;
+
+  bucket_count_ = 1;
+  while (bucket_count_ * 2 * sizeof(Bucket) <= bytes) {
+    bucket_count_ *= 2;
+  }
+
+  buckets_.reset(new Bucket[bucket_count_]);
+  generation_ = 0;
+}
+
+void TranspositionTable::Clear() {
+  for (size_t i = 0; i < bucket_count_; i++) {
+    for (Slot& slot : buckets_[i].slots) {
+      slot.check.store(0, std::memory_order_relaxed);
+      slot.data.store(0, std::memory_order_relaxed);
+    }
+  }
+  generation_ = 0;
+}
+
+void TranspositionTable::NewSearch() {
+  generation_ = (generation_ + 1) & ((1 << kGenerationBits) - 1);
+}
+
+bool TranspositionTable::Probe(uint64_t key, TranspositionEntry& entry) const {
+  for (const Slot& slot : BucketFor(key).slots) {
+    uint64_t data = slot.data.load(std::memory_order_relaxed);
+    uint64_t check = slot.check.load(std::memory_order_relaxed);
+
+    if ((check ^ data) == key && data != 0) {
+      entry = Unpack(data);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void TranspositionTable::Store(uint64_t key, const TranspositionEntry& entry) {
+  Bucket& bucket = BucketFor(key);
+  Slot* replace = nullptr;
+  int replace_worth = std::numeric_limits<int>::max();
+
+  for (Slot& slot : bucket.slots) {
+    uint64_t data = slot.data.load(std::memory_order_relaxed);
+    uint64_t check = slot.check.load(std::memory_order_relaxed);
+
+    if ((check ^ data) == key && data != 0) {
+      // Keep a deeper result for this position from the current search,
+      // unless the new one is exact.
+      if (GenerationOf(data) == generation_ && DepthOf(data) > entry.depth &&
+          entry.bound != kExactBound) {
+        return;
+      }
+      replace = &slot;
+      break;
+    }
+
+    // Otherwise evict the shallowest slot, counting each search of age as
+    // a few plies of depth.
+    int age = (generation_ - GenerationOf(data)) & ((1 << kGenerationBits) - 1);
+    int worth = data == 0 ? -1 : DepthOf(data) - 4 * age;
+    if (worth < replace_worth) {
+      replace = &slot;
+      replace_worth = worth;
+    }
+  }
+
+  uint64_t data = Pack(entry, generation_);
+  replace->check.store(key ^ data, std::memory_order_relaxed);
+  replace->data.store(data, std::memory_order_relaxed);
+}
+
+uint64_t TranspositionTable::Pack(const TranspositionEntry& entry,
+                                  uint8_t generation) {
+  int score;
+  if (std::isinf(entry.score)) {
+    score = entry.score > 0 ? kInfiniteScore : -kInfiniteScore;
+  } else {
+    score = static_cast<int>(std::lround(entry.score * 100));
+    score = std::max(-kInfiniteScore + 1, std::min(kInfiniteScore - 1, score));
+  }
+
+  return static_cast<uint64_t>(entry.move.Key()) |
+         static_cast<uint64_t>(static_cast<uint16_t>(score)) << 32 |
+         static_cast<uint64_t>(std::min(std::max(entry.depth, 0), 0xff)) << 48 |
+         static_cast<uint64_t>(entry.bound) << 56 |
+         static_cast<uint64_t>(generation) << 58;
+}
+
+TranspositionEntry TranspositionTable::Unpack(uint64_t data) {
+  int score = static_cast<int16_t>((data >> 32) & 0xffff);
+
+  TranspositionEntry entry;
+  entry.move = Action(static_cast<uint32_t>(data));
+  entry.depth = DepthOf(data);
+  entry.bound = static_cast<Bound>((data >> 56) & 0x3);
+
+  if (score >= kInfiniteScore) {
+    entry.score = std::numeric_limits<float>::infinity();
+  } else if (score <= -kInfiniteScore) {
+    entry.score = -std::numeric_limits<float>::infinity();
+  } else {
+    entry.score = static_cast<float>(score) / 100;
+  }
+
+  return entry;
+}
+
+}  // namespace ChessEngine
@@ -0,0 +1,101 @@
+//
+//  transposition-table.h
+//  chess_ai
+//
+//  Created by Illya Starikov on 10/14/26.
+//  Copyright 2026. Illya Starikov. All rights reserved.
+//
+
+#ifndef CHESS_AI_TRANSPOSITION_TABLE_H_
+#define CHESS_AI_TRANSPOSITION_TABLE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "action.h"
+
+namespace ChessEngine {
+
+enum Bound { kNoBound, kExactBound, kLowerBound, kUpperBound };
+
+// The same bound seen by the other side, whose scores are negated.
+constexpr Bound OpponentBound(Bound bound) {
+  return bound == kLowerBound   ? kUpperBound
+         : bound == kUpperBound ? kLowerBound
+                                : bound;
+}
+
+// A search result for one position, with the score from the point of view
+// of the side to move.
+struct TranspositionEntry {
+  float score;
+  Action move;
+  int depth;
+  Bound bound;
+};
+
+// Fixed-size hash table of search results keyed by Zobrist key. Slots are
+// written without locks: each one stores its packed data next to the key
+// XORed with that data, so a slot torn by two concurrent writers fails the
+// key check and reads as a miss instead of returning mixed results.
+class TranspositionTable {
+ public:
+  static const size_t kDefaultMegabytes = 16;
+
+  explicit TranspositionTable(size_t megabytes = kDefaultMegabytes);
+
+  TranspositionTable(const TranspositionTable& other) = delete;
+  TranspositionTable& operator=(const TranspositionTable& other) = delete;
+
+  // Reallocates to the largest power-of-two bucket count that fits. Not
+  // safe while a search is running.
+  void Resize(size_t megabytes);
+  void Clear();
+
+  // Ages the entries of previous searches so they are replaced first.
+  void NewSearch();
+
+  bool Probe(uint64_t key, TranspositionEntry& entry) const;
+  void Store(uint64_t key, const TranspositionEntry& entry);
+
+  size_t SizeInBytes() const { return bucket_count_ * sizeof(Bucket); }
+
+ private:
+  static const int kSlotsPerBucket = 4;
+  static const int kGenerationBits = 6;
+
+  struct Slot {
+    std::atomic<uint64_t> check{0};
+    std::atomic<uint64_t> data{0};
+  };
+
+  // One cache line per bucket.
+  struct alignas(64) Bucket {
+    Slot slots[kSlotsPerBucket];
+  };
+
+  // Data layout:
+  // 0-31   : Action key
+  // 32-47  : Score in hundredths of a pawn, saturated to int16
+  // 48-55  : Depth
+  // 56-57  : Bound
+  // 58-63  : Generation
+  static uint64_t Pack(const TranspositionEntry& entry, uint8_t generation);
+  static TranspositionEntry Unpack(uint64_t data);
+  static uint8_t GenerationOf(uint64_t data) { return data >> 58; }
+  static int DepthOf(uint64_t data) { return (data >> 48) & 0xff; }
+
+  Bucket& BucketFor(uint64_t key) const {
+    return buckets_[key & (bucket_count_ - 1)];
+  }
+
+  std::unique_ptr<Bucket[]> buckets_;
+  size_t bucket_count_;
+  uint8_t generation_;
+};
+
+}  // namespace ChessEngine
+
+#endif  // CHESS_AI_TRANSPOSITION_TABLE_H_
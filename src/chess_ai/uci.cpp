@@ -0,0 +1,322 @@
+//
+//  uci.cpp
+//  chess_ai
+//
+//  Created by Illya Starikov on 10/14/26.
+//  Copyright 2026. Illya Starikov. All rights reserved.
+//
+
+#include "uci.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+
+namespace ChessEngine {
+
+namespace {
+
+const double kNoTimeLimit = std::numeric_limits<double>::infinity();
+
+std::string SquareName(const Bitboard& square) {
+  int index = square.Lsb();
+  return {static_cast<char>('a' + index % 8),
+          static_cast<char>('1' + index / 8)};
+}
+
+char PromotionLetter(Piece piece) {
+  switch (piece) {
+    case kQueen:
+      return 'q';
+    case kRook:
+      return 'r';
+    case kBishop:
+      return 'b';
+    default:
+      return 'n';
+  }
+}
+
+}  // namespace
+
+UciProtocol::UciProtocol(std::istream& input, std::ostream& output)
+    : input_(input),
+      output_(output),
+      ai_(new ChessAI(kStartingFen)),
+      stop_requested_(false),
+      infinite_search_(false),
+      own_book_(true) {}
+
+UciProtocol::~UciProtocol() { StopSearch(); }
+
+void UciProtocol::Loop() {
+  std::string line;
+  bool quit = false;
+
+  while (!quit && std::getline(input_, line)) {
+    std::istringstream arguments(line);
+    std::string command;
+    arguments >> command;
+
+    if (command == "uci") {
+      Identify();
+    } else if (command == "isready") {
+      Send("readyok");
+    } else if (command == "setoption") {
+      SetOption(arguments);
+    } else if (command == "ucinewgame") {
+      StopSearch();
+      ChessAI::transposition_table_.Clear();
+      ai_.reset(new ChessAI(kStartingFen));
+    } else if (command == "position") {
+      Position(arguments);
+    } else if (command == "go") {
+      Go(arguments);
+    } else if (command == "stop") {
+      StopSearch();
+    } else if (command == "quit") {
+      quit = true;
+    }
+    // Unknown commands are ignored, as the protocol requires.
+  }
+
+  // When input simply runs out, let a timed search finish and report.
+  if (!quit && !infinite_search_ && search_thread_.joinable()) {
+    search_thread_.join();
+  }
+  StopSearch();
+}
+
+std::string UciProtocol::MoveToString(const Action& action) {
+  std::string rank = action.GetColor() == kWhite ? "1" : "8";
+
+  // Castling is encoded as the rook's move; UCI names the king's.
+  if (action.QueenSideCastling()) {
+    return "e" + rank + "c" + rank;
+  } else if (action.KingSideCastling()) {
+    return "e" + rank + "g" + rank;
+  }
+
+  std::string move =
+      SquareName(action.PieceBefore()) + SquareName(action.PieceAfter());
+  if (action.WasPromotion()) {
+    move += PromotionLetter(action.PromotedTo());
+  }
+
+  return move;
+}
+
+bool UciProtocol::ParseMove(const State& state, const std::string& move,
+                            Action& action) {
+  std::string lowercase = move;
+  std::transform(lowercase.begin(), lowercase.end(), lowercase.begin(),
+                 [](unsigned char ch) { return std::tolower(ch); });
+
+  for (const Action& candidate : ChessAI::Actions(state)) {
+    if (MoveToString(candidate) == lowercase) {
+      action = candidate;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void UciProtocol::Send(const std::string& line) {
+  std::lock_guard<std::mutex> lock(output_mutex_);
+  output_ << line << std::endl;
+}
+
+void UciProtocol::Identify() {
+  Send("id name chess_ai");
+  Send("id author Illya Starikov");
+  Send("option name Hash type spin default " +
+       std::to_string(TranspositionTable::kDefaultMegabytes) +
+       " min 1 max 65536");
+  Send("option name Threads type spin default 1 min 1 max 256");
+  Send("option name Search type combo default pvs var pvs var minimax");
+  Send("option name OwnBook type check default true");
+  Send("option name Book type string default <empty>");
+  Send("option name SyzygyPath type string default <empty>");
+  Send("uciok");
+}
+
+void UciProtocol::SetOption(std::istringstream& arguments) {
+  std::string token;
+  std::string name;
+  std::string value;
+
+  arguments >> token;  // "name"
+  while (arguments >> token && token != "value") {
+    name += name.empty() ? token : " " + token;
+  }
+  // The rest of the line, so that book paths may hold spaces.
+  std::getline(arguments >> std::ws, value);
+
+  StopSearch();
+
+  if (name == "Hash" && std::atoi(value.c_str()) > 0) {
+    ChessAI::SetHashSize(std::strtoul(value.c_str(), nullptr, 10));
+  } else if (name == "Threads" && std::atoi(value.c_str()) > 0) {
+    ChessAI::SetThreads(std::atoi(value.c_str()));
+  } else if (name == "Search" && (value == "pvs" || value == "minimax")) {
+    ChessAI::SetSearchAlgorithm(value == "pvs" ? kPrincipalVariationSearch
+                                               : kMinimaxSearch);
+  } else if (name == "OwnBook" && (value == "true" || value == "false")) {
+    own_book_ = value == "true";
+  } else if (name == "Book") {
+    std::string error;
+    if (value.empty() || value == "<empty>") {
+      ChessAI::book_.Close();
+    } else if (!ChessAI::OpenBook(value, error)) {
+      Send("info string " + error);
+    }
+  } else if (name == "SyzygyPath") {
+    std::string error;
+    if (!value.empty() && value != "<empty>" &&
+        !Tablebases::Init(value, error)) {
+      Send("info string " + error);
+    }
+  } else {
+    Send("info string unsupported option " + name);
+  }
+}
+
+void UciProtocol::Position(std::istringstream& arguments) {
+  std::string token;
+  std::string fen;
+
+  arguments >> token;
+  if (token == "startpos") {
+    fen = kStartingFen;
+    arguments >> token;  // "moves", if any
+  } else if (token == "fen") {
+    while (arguments >> token && token != "moves") {
+      fen += fen.empty() ? token : " " + token;
+    }
+  } else {
+    Send("info string expected startpos or fen");
+    return;
+  }
+
+  StopSearch();
+
+  try {
+    ai_.reset(new ChessAI(fen));
+  } catch (const std::logic_error& error) {
+    Send("info string invalid fen: " + std::string(error.what()));
+    ai_.reset(new ChessAI(kStartingFen));
+    return;
+  }
+
+  std::string move;
+  while (arguments >> move) {
+    Action action;
+    if (!ParseMove(ai_->current_state_, move, action)) {
+      Send("info string illegal move " + move);
+      return;
+    }
+    ai_->UpdateMove(action);
+  }
+}
+
+void UciProtocol::Go(std::istringstream& arguments) {
+  StopSearch();
+
+  double time_limit = kNoTimeLimit;
+  double time_remaining = -1;
+  double increment = 0;
+  int moves_to_go = 0;
+  int max_depth = kMaxSearchDepth;
+  bool infinite = false;
+
+  Color color_at_play = ai_->current_state_.color_at_play_;
+  std::string token;
+
+  while (arguments >> token) {
+    double value = 0;
+
+    if (token == "infinite") {
+      infinite = true;
+    } else if (token == "wtime" && arguments >> value) {
+      time_remaining = color_at_play == kWhite ? value / 1000 : time_remaining;
+    } else if (token == "btime" && arguments >> value) {
+      time_remaining = color_at_play == kBlack ? value / 1000 : time_remaining;
+    } else if (token == "winc" && arguments >> value) {
+      increment = color_at_play == kWhite ? value / 1000 : increment;
+    } else if (token == "binc" && arguments >> value) {
+      increment = color_at_play == kBlack ? value / 1000 : increment;
+    } else if (token == "movestogo" && arguments >> value) {
+      moves_to_go = std::max(0, static_cast<int>(value));
+    } else if (token == "movetime" && arguments >> value) {
+      time_limit = value / 1000;
+    } else if (token == "depth" && arguments >> value) {
+      max_depth = std::max(1, std::min(static_cast<int>(value), max_depth));
+    }
+  }
+
+  // A fixed move time wins over the clock.
+  bool on_clock =
+      time_remaining >= 0 && !infinite && time_limit == kNoTimeLimit;
+  if (on_clock) {
+    ai_->UpdateTimer(time_remaining, increment, moves_to_go);
+  }
+
+  if (ChessAI::Actions(ai_->current_state_).empty()) {
+    Send("bestmove 0000");
+    return;
+  }
+
+  // Analysis and fixed-depth searches want a search; games on the clock or
+  // on a move time may play from the book unless OwnBook is off.
+  Action book_move;
+  bool use_book = own_book_ && !infinite && max_depth == kMaxSearchDepth;
+  if (use_book && ai_->BookMove(book_move)) {
+    Send("info string book move");
+    Send("bestmove " + MoveToString(book_move));
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(stop_mutex_);
+    stop_requested_ = false;
+  }
+  ai_->ClearStop();
+  ai_->SetStatsOutput([this](const std::string& line) { Send(line); });
+  infinite_search_ = infinite || (!on_clock && time_limit == kNoTimeLimit &&
+                                  max_depth == kMaxSearchDepth);
+
+  search_thread_ = std::thread([this, time_limit, max_depth, infinite,
+                                on_clock]() {
+    Action move = on_clock ? ai_->SearchOnClock(max_depth)
+                           : ai_->Search(time_limit, max_depth);
+
+    // An infinite search may only report its move once told to stop.
+    if (infinite) {
+      std::unique_lock<std::mutex> lock(stop_mutex_);
+      stop_signal_.wait(lock, [this]() { return stop_requested_; });
+    }
+
+    Send("info depth " + std::to_string(ai_->CompletedDepth()));
+    Send("bestmove " + MoveToString(move));
+  });
+}
+
+void UciProtocol::StopSearch() {
+  if (!search_thread_.joinable()) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(stop_mutex_);
+    stop_requested_ = true;
+  }
+  stop_signal_.notify_all();
+  ai_->Stop();
+
+  search_thread_.join();
+}
+
+}  // namespace ChessEngine
@@ -0,0 +1,75 @@
+//
+//  uci.h
+//  chess_ai
+//
+//  Created by Illya Starikov on 10/14/26.
+//  Copyright 2026. Illya Starikov. All rights reserved.
+//
+
+#ifndef CHESS_AI_UCI_H_
+#define CHESS_AI_UCI_H_
+
+#include <condition_variable>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "action.h"
+#include "chess-ai.h"
+#include "state.h"
+
+namespace ChessEngine {
+
+// Long-running engine loop speaking the Universal Chess Interface. Commands
+// are read on the calling thread; searches run on a worker thread so that
+// stop, isready and quit are answered while the engine is thinking.
+class UciProtocol {
+ public:
+  UciProtocol(std::istream& input, std::ostream& output);
+  ~UciProtocol();
+
+  UciProtocol(const UciProtocol& other) = delete;
+  UciProtocol& operator=(const UciProtocol& other) = delete;
+
+  // Handles commands until quit or end of input.
+  void Loop();
+
+  // Long algebraic notation: e2e4, e7e8q, and castling as the king's move.
+  static std::string MoveToString(const Action& action);
+
+  // Finds the legal action the notation names in the state.
+  static bool ParseMove(const State& state, const std::string& move,
+                        Action& action);
+
+ private:
+  std::istream& input_;
+  std::ostream& output_;
+  std::mutex output_mutex_;
+
+  std::unique_ptr<ChessAI> ai_;
+
+  std::thread search_thread_;
+  std::mutex stop_mutex_;
+  std::condition_variable stop_signal_;
+  bool stop_requested_;
+
+  // Whether the running search only ends on stop.
+  bool infinite_search_;
+  // The OwnBook option: whether games may be played from the book.
+  bool own_book_;
+
+  void Send(const std::string& line);
+
+  void Identify();
+  void SetOption(std::istringstream& arguments);
+  void Position(std::istringstream& arguments);
+  void Go(std::istringstream& arguments);
+  void StopSearch();
+};
+
+}  // namespace ChessEngine
+
+#endif  // CHESS_AI_UCI_H_
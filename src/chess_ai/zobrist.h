@@ -0,0 +1,101 @@
+//
+//  zobrist.h
+//  chess_ai
+//
+//  Created by Illya Starikov on 10/14/26.
+//  Copyright 2026. Illya Starikov. All rights reserved.
+//
+
+#ifndef CHESS_AI_ZOBRIST_H_
+#define CHESS_AI_ZOBRIST_H_
+
+#include <cstdint>
+
+#include "bitboard.h"
+#include "chess-pieces.h"
+#include "color.h"
+#include "constants.h"
+
+namespace ChessEngine {
+
+// Key layout, filled at compile time by GenerateZobristKeys.
+struct ZobristKeys {
+  uint64_t pieces[2][kNumberOfPieces][64];
+  uint64_t castling[64];
+  uint64_t en_passant[8];
+  uint64_t side;
+};
+
+constexpr uint64_t SplitMix64(uint64_t& seed) {
+  uint64_t z = (seed += 0x9e3779b97f4a7c15ULL);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+constexpr ZobristKeys GenerateZobristKeys() {
+  ZobristKeys keys{};
+  uint64_t seed = 0x5a0b1157c0ffee00ULL;
+
+  for (auto& color : keys.pieces) {
+    for (auto& piece : color) {
+      for (uint64_t& key : piece) {
+        key = SplitMix64(seed);
+      }
+    }
+  }
+  for (uint64_t& key : keys.castling) {
+    key = SplitMix64(seed);
+  }
+  for (uint64_t& key : keys.en_passant) {
+    key = SplitMix64(seed);
+  }
+  keys.side = SplitMix64(seed);
+
+  return keys;
+}
+
+// Random keys for Zobrist hashing. A position's key is the XOR of the keys of
+// every piece on its square, the castling squares still available, the file
+// of the en passant pawn and, when black is to play, the side key. The keys
+// come from a fixed SplitMix64 stream, so they are identical on every run.
+class Zobrist {
+ public:
+  static uint64_t PieceKey(Color color, Piece piece, int square) {
+    return kKeys.pieces[color][piece][square];
+  }
+
+  // XOR of the piece keys of every square set in the board.
+  static uint64_t PieceKeys(Color color, Piece piece, const Bitboard& squares) {
+    uint64_t key = 0;
+    for (int square : squares) {
+      key ^= PieceKey(color, piece, square);
+    }
+    return key;
+  }
+
+  static uint64_t CastlingKeys(const Bitboard& castling_squares) {
+    uint64_t key = 0;
+    for (int square : castling_squares) {
+      key ^= kKeys.castling[square];
+    }
+    return key;
+  }
+
+  static uint64_t EnPassantKeys(const Bitboard& en_passant_squares) {
+    uint64_t key = 0;
+    for (int square : en_passant_squares) {
+      key ^= kKeys.en_passant[square % 8];
+    }
+    return key;
+  }
+
+  static uint64_t SideKey() { return kKeys.side; }
+
+ private:
+  static constexpr ZobristKeys kKeys = GenerateZobristKeys();
+};
+
+}  // namespace ChessEngine
+
+#endif  // CHESS_AI_ZOBRIST_H_